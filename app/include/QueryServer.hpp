@@ -0,0 +1,57 @@
+#ifndef DEBUGTOCPP_QUERYSERVER_HPP
+#define DEBUGTOCPP_QUERYSERVER_HPP
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "extractor/Extractor.hpp"
+#include "utils/cxxopts.h"
+#include "utils/json.hpp"
+
+using namespace debugtocpp;
+
+// Keeps loaded files in memory and answers queries sent over unix socket.
+// Every request is one line of json, response is one line of json:
+//   {"file": "game.pdb", "classes": ["c_Enemy"], "json": true, "pointers": true}
+//   {"ok": true, "output": "..."}
+// Keys other than "command", "file" and "classes" are the same as command line options.
+class QueryServer {
+public:
+    QueryServer(std::string socketPath, std::vector<std::pair<std::string, Extractor *>> extractors,
+                cxxopts::Options &options)
+            : socketPath(std::move(socketPath)), extractors(std::move(extractors)), options(options) {}
+
+    int run();
+
+private:
+    std::string socketPath;
+    std::vector<std::pair<std::string, Extractor *>> extractors;
+    cxxopts::Options &options;
+
+    // Extractors and option parser are not thread safe
+    std::mutex mutex;
+    std::atomic<bool> stopped{false};
+    int serverSocket = -1;
+
+    // Client threads are joined before run() returns, finished ones when the next client connects
+    struct Client {
+        std::thread thread;
+        int socket = -1;
+        bool finished = false;
+    };
+    std::mutex clientsMutex;
+    std::list<Client> clients;
+
+    void joinFinishedClients();
+    void handleClient(Client *client);
+    void serveClient(int client);
+    std::string handleRequest(const std::string &line);
+    Extractor * getExtractor(const std::string &file);
+    std::vector<std::string> getArguments(const nlohmann::json &request);
+};
+
+#endif //DEBUGTOCPP_QUERYSERVER_HPP
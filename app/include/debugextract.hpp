@@ -15,9 +15,36 @@ using namespace debugtocpp::elf;
 using namespace debugtocpp::pdb;
 using namespace debugtocpp::dwarf;
 
+struct Query {
+    std::list<std::string> classes;
+    bool all = false;
+    bool list = false;
+    bool vars = false;
+    std::string at;
+    bool allowStdin = false; // Only the query of the command line may read addresses from stdin
+    std::string output;
+    DumpConfig config;
+};
+
+cxxopts::Options getOptions();
+Query argsToQuery(const cxxopts::ParseResult &args, size_t classesPosition);
 DumpConfig argsToConfig(const cxxopts::ParseResult &args);
-Extractor * getExtractorForFile(const std::string &filename, int base);
+ClassDumper * getDumper(const DumpConfig &config);
+std::ios::openmode getOpenMode(const DumpConfig &config);
+Extractor * getExtractorForFile(const std::string &filename, int base, int elfBase);
+Extractor * getExtractorForFiles(const std::list<std::string> &filenames, int base, int elfBase);
+
+int runQuery(Extractor * extractor, Query &query, std::ostream &defaultOut);
+int runBatch(Extractor * extractor, cxxopts::Options &options, const std::string &path);
+int serve(const std::string &socketPath, const std::vector<std::string> &files, int base, int elfBase,
+          cxxopts::Options &options);
 
-void list(Extractor * extractor, Analyser &analyser);
+void list(Extractor * extractor, Analyser &analyser, std::ostream &out);
+int lookupAddresses(Extractor * extractor, const std::string &at, bool allowStdin, const DumpConfig &config,
+                    std::ostream &out);
+int dumpToDirectory(std::vector<Type *> &types, ClassDumper * dumper, DumpConfig &config, const std::string &path,
+                    std::ostream &out);
+void dumpJsonLines(Extractor * extractor, Analyser &analyser, ClassDumper * dumper, std::list<std::string> names,
+                   DumpConfig &config, std::ostream &out);
 
 #endif //DEBUGTOCPP_DEBUGEXTRACT_HPP
@@ -0,0 +1,300 @@
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../include/QueryServer.hpp"
+#include "../include/debugextract.hpp"
+#include "dumper/JsonWriter.hpp"
+
+using json = nlohmann::json;
+
+namespace {
+
+// Longest request line, a client sending more without a newline is disconnected
+const size_t MAX_REQUEST_SIZE = 1 << 20;
+
+// Options that would let clients write files or start nested batches and servers
+const char * const FORBIDDEN_OPTIONS[] = {"output", "batch", "serve"};
+
+}
+
+int QueryServer::run() {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cout << "Socket path is too long: " << socketPath << std::endl;
+        return 2;
+    }
+    strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    serverSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (serverSocket < 0) {
+        std::cout << "Failed to create socket: " << strerror(errno) << std::endl;
+        return 2;
+    }
+
+    // Remove socket left by previous instance
+    unlink(socketPath.c_str());
+
+    if (bind(serverSocket, (sockaddr *) &address, sizeof(address)) != 0 || listen(serverSocket, 16) != 0) {
+        std::cout << "Failed to listen on " << socketPath << ": " << strerror(errno) << std::endl;
+        close(serverSocket);
+        return 2;
+    }
+
+    std::cout << "Listening on " << socketPath << std::endl;
+
+    while (!stopped) {
+        int client = accept(serverSocket, nullptr, nullptr);
+
+        if (client < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(clientsMutex);
+        joinFinishedClients();
+
+        clients.emplace_back();
+        Client &entry = clients.back();
+        entry.socket = client;
+        entry.thread = std::thread(&QueryServer::handleClient, this, &entry);
+    }
+
+    close(serverSocket);
+    unlink(socketPath.c_str());
+
+    // Clients waiting for requests are woken up, requests in progress still get their responses
+    {
+        std::lock_guard<std::mutex> lock(clientsMutex);
+        for (auto &client : clients) {
+            if (!client.finished) {
+                ::shutdown(client.socket, SHUT_RD);
+            }
+        }
+    }
+
+    for (auto &client : clients) {
+        client.thread.join();
+    }
+    clients.clear();
+
+    return 0;
+}
+
+// Called with clientsMutex locked
+void QueryServer::joinFinishedClients() {
+    for (auto it = clients.begin(); it != clients.end();) {
+        if (it->finished) {
+            it->thread.join();
+            it = clients.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// Socket is closed under the lock, so that shutdown in run() never hits a reused descriptor
+void QueryServer::handleClient(Client *client) {
+    serveClient(client->socket);
+
+    std::lock_guard<std::mutex> lock(clientsMutex);
+    close(client->socket);
+    client->finished = true;
+}
+
+void QueryServer::serveClient(int client) {
+    std::string buffer;
+    char chunk[4096];
+
+    while (true) {
+        ssize_t received = recv(client, chunk, sizeof(chunk), 0);
+        if (received <= 0) {
+            break;
+        }
+
+        buffer.append(chunk, static_cast<size_t>(received));
+
+        if (buffer.size() > MAX_REQUEST_SIZE && buffer.find('\n') == std::string::npos) {
+            std::string response = "{\"ok\":false,\"error\":\"Request is too long\"}\n";
+            send(client, response.data(), response.size(), MSG_NOSIGNAL);
+            return;
+        }
+
+        size_t lineEnd;
+        while ((lineEnd = buffer.find('\n')) != std::string::npos) {
+            std::string line = buffer.substr(0, lineEnd);
+            buffer.erase(0, lineEnd + 1);
+
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+
+            std::string response = handleRequest(line);
+
+            size_t sent = 0;
+            while (sent < response.size()) {
+                ssize_t result = send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+                if (result <= 0) {
+                    return;
+                }
+                sent += static_cast<size_t>(result);
+            }
+        }
+    }
+}
+
+std::string QueryServer::handleRequest(const std::string &line) {
+    bool ok = true;
+    std::string output;
+    std::string error;
+
+    try {
+        json request = json::parse(line);
+        std::string command = request.value("command", "query");
+
+        if (command == "shutdown") {
+            stopped = true;
+            shutdown(serverSocket, SHUT_RDWR);
+        } else if (command == "files") {
+            for (auto &extractor : extractors) {
+                output += extractor.first + "\n";
+            }
+        } else if (command == "query") {
+            Extractor * extractor = getExtractor(request.value("file", ""));
+            std::vector<std::string> tokens = getArguments(request);
+
+            std::vector<char *> arguments;
+            for (auto &token : tokens) {
+                arguments.push_back(&token[0]);
+            }
+
+            int count = static_cast<int>(arguments.size());
+            char ** values = arguments.data();
+            std::stringstream out;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                auto args = options.parse(count, values);
+                Query query = argsToQuery(args, 0);
+
+                if (query.config.binary) {
+                    throw std::string("Binary output is not available over the socket");
+                }
+
+                ok = runQuery(extractor, query, out) == 0;
+            }
+
+            output = out.str();
+        } else {
+            throw std::string("Unknown command: " + command);
+        }
+    } catch (std::string &e) {
+        ok = false;
+        error = e;
+    } catch (const json::exception &e) {
+        ok = false;
+        error = e.what();
+    } catch (const cxxopts::OptionException &e) {
+        ok = false;
+        error = e.what();
+    } catch (const std::exception &e) {
+        // Errors of extractors (e.g. malformed debug information) fail only the request, not the server
+        ok = false;
+        error = e.what();
+    } catch (...) {
+        ok = false;
+        error = "Unknown error";
+    }
+
+    std::stringstream response;
+    JsonWriter writer(response, -1);
+
+    writer.beginObject();
+    writer.key("ok");
+    writer.value(ok);
+    if (!error.empty()) {
+        writer.key("error");
+        writer.value(error);
+    } else {
+        writer.key("output");
+        writer.value(output);
+    }
+    writer.endObject();
+
+    response << "\n";
+    return response.str();
+}
+
+Extractor * QueryServer::getExtractor(const std::string &file) {
+    if (file.empty()) {
+        return extractors[0].second;
+    }
+
+    for (auto &extractor : extractors) {
+        if (extractor.first == file) {
+            return extractor.second;
+        }
+    }
+
+    throw std::string("File is not loaded: " + file);
+}
+
+// Converts request to command line arguments so that it is handled the same way as --batch
+std::vector<std::string> QueryServer::getArguments(const json &request) {
+    std::vector<std::string> tokens = {"debugtocpp"};
+
+    if (request.count("classes")) {
+        std::string classes;
+        for (auto &name : request["classes"]) {
+            classes += (classes.empty() ? "" : ",") + name.get<std::string>();
+        }
+
+        if (!classes.empty()) {
+            if (classes[0] == '-') {
+                throw std::string("Invalid class name: " + classes);
+            }
+
+            tokens.push_back(classes);
+        }
+    }
+
+    for (auto it = request.begin(); it != request.end(); ++it) {
+        const std::string &key = it.key();
+        if (key == "command" || key == "file" || key == "classes") {
+            continue;
+        }
+
+        // Only long option names, values are joined to them so that they can't be read as other options
+        bool valid = key.size() > 1 && key.find_first_not_of("abcdefghijklmnopqrstuvwxyz-") == std::string::npos &&
+                     key[0] != '-';
+        for (const char * forbidden : FORBIDDEN_OPTIONS) {
+            valid = valid && key != forbidden;
+        }
+
+        if (!valid) {
+            throw std::string("Option is not allowed: " + key);
+        }
+
+        if (it->is_boolean()) {
+            if (it->get<bool>()) {
+                tokens.push_back("--" + key);
+            }
+        } else if (it->is_string()) {
+            tokens.push_back("--" + key + "=" + it->get<std::string>());
+        } else if (it->is_number()) {
+            tokens.push_back("--" + key + "=" + it->dump());
+        }
+    }
+
+    return tokens;
+}
@@ -1,26 +1,81 @@
+#include <algorithm>
+#include <cctype>
 #include <utility>
 
 #include <utility>
 #include <iostream>
 #include <fstream>
+#include <future>
+#include <memory>
 #include <iostream>
 
 #include "../include/debugextract.hpp"
 
 #include "common/Analyser.hpp"
 #include "common/DebugTypes.hpp"
+#include "dumper/BinaryClassDumper.hpp"
 #include "dumper/CodeClassDumper.hpp"
+#include "dumper/DirectoryWriter.hpp"
 #include "dumper/JsonClassDumper.hpp"
+#include "dumper/JsonWriter.hpp"
+#include "QueryServer.hpp"
 #include "extractor/pdb/PDBExtractor.hpp"
 #include "extractor/elf/ELFExtractor.hpp"
 #include "extractor/dwarf/DWARFExtractor.hpp"
+#include "extractor/MultiExtractor.hpp"
 #include "utils/cxxopts.h"
 #include "utils/utils.hpp"
 
 int main(int argc, char *argv[]) {
+    cxxopts::Options options = getOptions();
+    auto args = options.parse(argc, argv);
+
+    if (args.count("help") || !args.count("positional")) {
+        std::cout << options.help({"", "display"}) << std::endl;
+        return 0;
+    }
+
+    auto &v = args["positional"].as<std::vector<std::string>>();
+    bool batch = args.count("batch") > 0;
+
+    // Default base is the one of PE images, ELF addresses stay as linked unless it is given
+    int base = args["base"].as<int>();
+    int elfBase = args.count("base") ? base : 0;
+
+    if (args.count("serve")) {
+        return serve(args["serve"].as<std::string>(), v, base, elfBase, options);
+    }
+    if ((v.size() < 2 && !(args.count("all") || args.count("list") || args.count("vars") || args.count("at") || batch)) || v.empty()) {
+        std::cout << options.help({"", "display"}) << std::endl;
+        return 1;
+    }
+
+    Extractor * extractor;
+    try {
+        extractor = getExtractorForFiles(split(v[0], ','), base, elfBase);
+    } catch (std::string &error){
+        std::cout << error << std::endl;
+        return 2;
+    }
+
+    if (batch) {
+        return runBatch(extractor, options, args["batch"].as<std::string>());
+    }
+
+    Query query = argsToQuery(args, 1);
+    query.allowStdin = true;
+    try {
+        return runQuery(extractor, query, std::cout);
+    } catch (std::string &error) {
+        std::cout << error << std::endl;
+        return 1;
+    }
+}
+
+cxxopts::Options getOptions() {
     cxxopts::Options options("debugtocpp", "Generate C++ classes from pdb/dwarf");
     options
-            .positional_help("<pdb_file> [class_name]")
+            .positional_help("<pdb_file>[,<pdb_file>...] [class_name]")
             .show_positional_help();
 
     options.allow_unrecognised_options().add_options()
@@ -30,43 +85,87 @@ int main(int argc, char *argv[]) {
             ("l,list", "List all classes")
             ("o,output", "Output path", cxxopts::value<std::string>())
             ("v,vars", "Show all global variables")
+            ("at", "Show functions and global variables containing hex addresses, comma separated or - for stdin", cxxopts::value<std::string>())
+            ("batch", "Run queries from file (- for stdin), one per line: [class_name] [options]", cxxopts::value<std::string>())
+            ("serve", "Load all input files and answer json queries on unix socket", cxxopts::value<std::string>())
             ("positional", "...", cxxopts::value<std::vector<std::string>>());
     options.parse_positional({"input", "class", "positional"});
 
     options.add_options("display")
             ("indent", "Output indentation level", cxxopts::value<int>()->default_value("2"))
             ("j,json", "Show output as json")
+            ("jsonl", "Show output as newline-delimited json (one type per line)")
+            ("binary", "Output binary model readable with common/BinaryModel.hpp")
             ("no-compiler-generated", "Don't show compiler generated types/methods")
             ("c,compilable", "Modifies output so that it can be compiled")
             ("p,pointers", "Show members as pointers");
 
-    auto args = options.parse(argc, argv);
+    return options;
+}
 
-    if (args.count("help") || !args.count("positional")) {
-        std::cout << options.help({"", "display"}) << std::endl;
-        return 0;
-    }
+// Answers all queries using the same extractor, so the input file is loaded only once
+int runBatch(Extractor * extractor, cxxopts::Options &options, const std::string &path) {
+    std::ifstream file;
+    if (path != "-") {
+        file.open(path);
 
-    auto &v = args["positional"].as<std::vector<std::string>>();
-    if ((v.size() < 2 && !(args.count("all") || args.count("list") || args.count("vars"))) || v.empty()) {
-        std::cout << options.help({"", "display"}) << std::endl;
-        return 1;
+        if (!file.is_open()) {
+            std::cout << "Failed to open batch file: " << path << std::endl;
+            return 2;
+        }
     }
 
-    Extractor * extractor;
-    try {
-        extractor = getExtractorForFile(v[0], args["base"].as<int>());
-    } catch (std::string &error){
-        std::cout << error << std::endl;
-        return 2;
+    std::istream &in = path != "-" ? file : std::cin;
+    int result = 0;
+    int lineNumber = 0;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        lineNumber++;
+
+        std::vector<std::string> tokens = splitArguments(line);
+        if (tokens.empty() || tokens[0][0] == '#') {
+            continue;
+        }
+
+        tokens.insert(tokens.begin(), "debugtocpp");
+
+        std::vector<char *> arguments;
+        for (auto &token : tokens) {
+            arguments.push_back(&token[0]);
+        }
+
+        int count = static_cast<int>(arguments.size());
+        char ** values = arguments.data();
+
+        try {
+            auto args = options.parse(count, values);
+            Query query = argsToQuery(args, 0);
+
+            if (runQuery(extractor, query, std::cout) != 0) {
+                result = 1;
+            }
+        } catch (std::string &error) {
+            std::cerr << "Query on line " << lineNumber << ": " << error << std::endl;
+            result = 1;
+        } catch (const cxxopts::OptionException &e) {
+            std::cerr << "Query on line " << lineNumber << ": " << e.what() << std::endl;
+            result = 1;
+        }
     }
 
-    DumpConfig config = argsToConfig(args);
+    return result;
+}
 
-    std::string outputPath;
-    if (args.count("output")) {
-        outputPath = args["output"].as<std::string>();
+int runQuery(Extractor * extractor, Query &query, std::ostream &defaultOut) {
+    DumpConfig config = query.config;
+
+    if (query.classes.empty() && !(query.all || query.list || query.vars || !query.at.empty())) {
+        throw std::string("No classes specified");
+    }
 
+    std::string outputPath = query.output;
+    if (!outputPath.empty()) {
         // Remove trailing slash
         if (outputPath.back() == '/' || outputPath.back() == '\\') {
             outputPath.pop_back();
@@ -81,79 +180,255 @@ int main(int argc, char *argv[]) {
     }
 
     Analyser analyser{config};
-    ClassDumper * dumper = config.json ? (ClassDumper *) new JsonClassDumper : new CodeClassDumper;
+    // Batch and server run many queries, everything allocated for one is released when it ends
+    std::unique_ptr<ClassDumper> dumper(getDumper(config));
+    std::unique_ptr<Type> globalVariables;
+
+    std::ofstream file;
+    if (!outputPath.empty() && !config.toDirectory) {
+        file.open(outputPath, getOpenMode(config));
+    }
 
-    if (args.count("list")) {
-        list(extractor, analyser);
+    // Stream output directly instead of keeping everything in memory
+    std::ostream &out = file.is_open() ? file : defaultOut;
+
+    if (query.list) {
+        list(extractor, analyser, out);
         return 0;
     }
 
+    if (!query.at.empty()) {
+        return lookupAddresses(extractor, query.at, query.allowStdin, config, out);
+    }
+
     std::vector<Type *> types;
-    std::vector<std::string> dumpOut;
 
-    if (args.count("vars")) {
-        Type * type = new Type("GlobalVariables");
-        type->fields = extractor->getAllGlobalVariables();
+    if (query.vars) {
+        globalVariables.reset(new Type("GlobalVariables"));
+        globalVariables->fields = extractor->getAllGlobalVariables();
 
-        types.push_back(type);
-        dumpOut.push_back(dumper->dump(type, config));
+        types.push_back(globalVariables.get());
     } else {
-        std::list<std::string> names;
-        if (args.count("all") > 0) {
-            names = extractor->getTypesList(false);
-        } else {
-            names = split(v[1], ',');
+        std::list<std::string> names = query.all ? extractor->getTypesList(false) : query.classes;
+
+        if (config.jsonLines && !config.toDirectory) {
+            dumpJsonLines(extractor, analyser, dumper.get(), std::move(names), config, out);
+            return 0;
         }
 
+        // Extractors return nullptr for unknown classes
         types = extractor->getTypes(std::move(names));
+        types.erase(std::remove(types.begin(), types.end(), nullptr), types.end());
         analyser.process(types);
-
-        dumpOut = dumper->dump(std::move(types), config);
     }
 
     if (config.toDirectory) {
-        std::string extension = (config.json ? "json" : "hpp");
+        return dumpToDirectory(types, dumper.get(), config, outputPath, out);
+    }
+
+    if (query.vars) {
+        out << dumper->dump(types[0], config) << (config.binary ? "" : "\n");
+    } else {
+        dumper->dump(std::move(types), config, out);
+    }
 
-        for (int i = 0; i < dumpOut.size(); i++) {
-            std::ofstream file;
-            file.open(outputPath + "/" + clearString(types[i]->name) + "." + extension);
+    out.flush();
+    return 0;
+}
 
-            file << dumpOut[i];
-            file.close();
+int dumpToDirectory(std::vector<Type *> &types, ClassDumper * dumper, DumpConfig &config, const std::string &path,
+                    std::ostream &out) {
+    std::string extension = (config.binary ? "dtcb" : config.json ? "json" : "hpp");
+    DirectoryWriter writer(path, config.binary);
+
+    // Files are written in background while next types are rendered
+    for (auto type : types) {
+        writer.write(clearString(type->name) + "." + extension, dumper->dump(type, config));
+    }
+
+    WriteStats stats = writer.finish();
+    out << "Written: " << stats.written << ", unchanged: " << stats.unchanged;
+    if (stats.failed > 0) {
+        out << ", failed: " << stats.failed;
+    }
+    out << std::endl;
+
+    return stats.failed > 0 ? 3 : 0;
+}
+
+// Extracts and writes types in chunks so that consumers can start reading before the dump is finished
+void dumpJsonLines(Extractor * extractor, Analyser &analyser, ClassDumper * dumper, std::list<std::string> names,
+                   DumpConfig &config, std::ostream &out) {
+    const size_t chunkSize = 256;
+
+    while (!names.empty()) {
+        std::list<std::string> chunk;
+        auto end = names.begin();
+        std::advance(end, std::min(chunkSize, names.size()));
+        chunk.splice(chunk.begin(), names, names.begin(), end);
+
+        std::vector<Type *> types = extractor->getTypes(std::move(chunk));
+        types.erase(std::remove(types.begin(), types.end(), nullptr), types.end());
+        analyser.process(types);
+
+        dumper->dump(std::move(types), config, out);
+        out.flush();
+    }
+}
+
+void list(Extractor * extractor, Analyser &analyser, std::ostream &out) {
+    for (auto &type : extractor->getTypesList(false)) {
+        if (!analyser.isCompilerGeneratedType(type)) {
+            out << type << std::endl;
+        }
+    }
+}
+
+// All addresses are looked up at once, sorted and resolved with one pass over the address index
+int lookupAddresses(Extractor * extractor, const std::string &at, bool allowStdin, const DumpConfig &config,
+                    std::ostream &out) {
+    std::vector<std::string> tokens;
+    if (at == "-") {
+        if (!allowStdin) {
+            throw std::string("Addresses can be read from stdin only on the command line");
+        }
+
+        std::string token;
+        while (std::cin >> token) {
+            tokens.push_back(token);
         }
     } else {
-        std::string out = join(dumpOut, "\n");
+        for (auto &token : split(at, ',')) {
+            tokens.push_back(token);
+        }
+    }
+
+    std::vector<uint64_t> addresses;
+    addresses.reserve(tokens.size());
+
+    for (auto &token : tokens) {
+        // stoull accepts signs and leading spaces, which would wrap negative addresses around
+        size_t end = 0;
+        if (token.empty() || !isxdigit(static_cast<unsigned char>(token[0]))) {
+            throw std::string("Invalid address: " + token);
+        }
+
+        try {
+            addresses.push_back(std::stoull(token, &end, 16));
+        } catch (std::exception &e) {
+            throw std::string("Invalid address: " + token);
+        }
+
+        if (end != token.size()) {
+            throw std::string("Invalid address: " + token);
+        }
+    }
+
+    std::vector<const AddressRange *> ranges = extractor->getAddressIndex().find(addresses);
+
+    if (config.json) {
+        JsonWriter writer(out, config.indent);
+        writer.beginArray();
+
+        for (size_t i = 0; i < addresses.size(); i++) {
+            writer.beginObject();
+            writer.key("address");
+            writer.value(static_cast<unsigned long>(addresses[i]));
+
+            if (ranges[i] != nullptr) {
+                writer.key("name");
+                writer.value(ranges[i]->name);
+                writer.key("start");
+                writer.value(static_cast<unsigned long>(ranges[i]->start));
+                writer.key("size");
+                writer.value(static_cast<unsigned long>(ranges[i]->size));
+                writer.key("function");
+                writer.value(ranges[i]->isFunction);
+            }
+
+            writer.endObject();
+        }
+
+        writer.endArray();
+        out << std::endl;
+        return 0;
+    }
 
-        if (args.count("output")) {
-            std::ofstream file;
-            file.open(outputPath);
+    // One line per address: 0x401005 Foo::get+0x5, unknown addresses have ?? instead of the name
+    out << std::hex;
+    for (size_t i = 0; i < addresses.size(); i++) {
+        out << "0x" << addresses[i] << " ";
 
-            file << out;
-            file.close();
+        if (ranges[i] == nullptr) {
+            out << "??\n";
+        } else if (addresses[i] == ranges[i]->start) {
+            out << ranges[i]->name << "\n";
         } else {
-            std::cout << out;
+            out << ranges[i]->name << "+0x" << addresses[i] - ranges[i]->start << "\n";
         }
     }
+    out << std::dec;
 
+    out.flush();
     return 0;
 }
 
-void list(Extractor * extractor, Analyser &analyser) {
-    for (auto &type : extractor->getTypesList(false)) {
-        if (!analyser.isCompilerGeneratedType(type)) {
-            std::cout << type << std::endl;
+int serve(const std::string &socketPath, const std::vector<std::string> &files, int base, int elfBase,
+          cxxopts::Options &options) {
+    std::vector<std::pair<std::string, Extractor *>> extractors;
+
+    for (auto &filename : files) {
+        try {
+            extractors.emplace_back(filename, getExtractorForFiles(split(filename, ','), base, elfBase));
+        } catch (std::string &error) {
+            std::cout << filename << ": " << error << std::endl;
+            return 2;
+        }
+    }
+
+    QueryServer server(socketPath, extractors, options);
+    return server.run();
+}
+
+// Inputs are loaded in parallel and merged, types present in several files are extracted once
+Extractor * getExtractorForFiles(const std::list<std::string> &filenames, int base, int elfBase) {
+    if (filenames.size() == 1) {
+        return getExtractorForFile(filenames.front(), base, elfBase);
+    }
+
+    std::vector<std::future<Extractor *>> loading;
+    for (auto &filename : filenames) {
+        loading.push_back(std::async(std::launch::async, getExtractorForFile, filename, base, elfBase));
+    }
+
+    std::vector<Extractor *> extractors;
+    std::string errors;
+
+    auto filename = filenames.begin();
+    for (auto &result : loading) {
+        try {
+            extractors.push_back(result.get());
+        } catch (std::string &error) {
+            errors += *filename + ": " + error;
         }
+        ++filename;
+    }
+
+    if (!errors.empty()) {
+        throw errors;
     }
+
+    return new MultiExtractor(extractors);
 }
 
-Extractor * getExtractorForFile(const std::string &filename, int base) {
+Extractor * getExtractorForFile(const std::string &filename, int base, int elfBase) {
     auto * pdbExtractor = new PDBExtractor;
     auto * elfExtractor = new ELFExtractor;
     auto * dwarfExtractor = new DWARFExtractor;
 
     ExtractResult pdbExtractResult = pdbExtractor->load(filename, base);
-    ExtractResult elfExtractResult = elfExtractor->load(filename, base);
-    ExtractResult dwarfExtractResult = dwarfExtractor->load(filename, base);
+    ExtractResult elfExtractResult = elfExtractor->load(filename, elfBase);
+    ExtractResult dwarfExtractResult = dwarfExtractor->load(filename, elfBase);
 
     if (pdbExtractResult == ExtractResult::OK) {
         return pdbExtractor;
@@ -180,10 +455,51 @@ Extractor * getExtractorForFile(const std::string &filename, int base) {
     throw errorMessage.str();
 }
 
+ClassDumper * getDumper(const DumpConfig &config) {
+    if (config.binary) {
+        return new BinaryClassDumper;
+    } else if (config.json) {
+        return new JsonClassDumper;
+    }
+
+    return new CodeClassDumper;
+}
+
+std::ios::openmode getOpenMode(const DumpConfig &config) {
+    return config.binary ? std::ios::out | std::ios::binary : std::ios::out;
+}
+
+Query argsToQuery(const cxxopts::ParseResult &args, size_t classesPosition) {
+    Query query;
+    query.config = argsToConfig(args);
+    query.all = args.count("all") > 0;
+    query.list = args.count("list") > 0;
+    query.vars = args.count("vars") > 0;
+
+    if (args.count("at")) {
+        query.at = args["at"].as<std::string>();
+    }
+
+    if (args.count("output")) {
+        query.output = args["output"].as<std::string>();
+    }
+
+    if (args.count("positional")) {
+        auto &v = args["positional"].as<std::vector<std::string>>();
+        if (v.size() > classesPosition) {
+            query.classes = split(v[classesPosition], ',');
+        }
+    }
+
+    return query;
+}
+
 DumpConfig argsToConfig(const cxxopts::ParseResult &args) {
     DumpConfig config;
     config.indent = args["indent"].as<int>();
-    config.json = args.count("json") > 0;
+    config.binary = args.count("binary") > 0;
+    config.jsonLines = args.count("jsonl") > 0 && !config.binary;
+    config.json = args.count("json") > 0 || config.jsonLines;
     config.showAsPointers = args.count("pointers") > 0;
     config.noCompilerGenerated = args.count("no-compiler-generated") > 0;
 
@@ -0,0 +1,44 @@
+#ifndef DEBUGTOCPP_ADDRESSINDEX_HPP
+#define DEBUGTOCPP_ADDRESSINDEX_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace debugtocpp {
+
+// Function or global variable occupying [start, start + size), ranges without size cover only their start
+struct AddressRange {
+    uint64_t start = 0;
+    uint64_t size = 0;
+    std::string name;
+    bool isFunction = false;
+};
+
+// Sorted disjoint intervals built from possibly nested or overlapping ranges, the innermost range wins
+class AddressIndex {
+public:
+    explicit AddressIndex(std::vector<AddressRange> ranges);
+
+    // nullptr when no range contains the address
+    const AddressRange *find(uint64_t address) const;
+
+    // Result is in the order of addresses, which are looked up in sorted order with one pass over the intervals
+    std::vector<const AddressRange *> find(const std::vector<uint64_t> &addresses) const;
+
+    size_t size() const { return ranges.size(); }
+
+private:
+    struct Interval {
+        uint64_t start;
+        uint64_t end;
+        uint32_t range;
+    };
+
+    std::vector<AddressRange> ranges;
+    std::vector<Interval> intervals;
+};
+
+}
+
+#endif //DEBUGTOCPP_ADDRESSINDEX_HPP
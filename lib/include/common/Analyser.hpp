@@ -1,6 +1,7 @@
 #ifndef DEBUGTOCPP_ANALYSER_HPP
 #define DEBUGTOCPP_ANALYSER_HPP
 
+#include <memory>
 #include "DebugTypes.hpp"
 #include "dumper/ClassDumper.hpp"
 
@@ -13,12 +14,15 @@ public:
     Analyser(const DumpConfig &config) : config(config) {}
 
     void process(std::vector<Type *> &types);
-    bool process(Type * type);
+    bool process(Type *& type);
     bool isCompilerGeneratedType(std::string &name);
     bool isCompilerGenerated(Type * type);
     bool isCompilerGenerated(Method * method);
 private:
     DumpConfig config;
+
+    // Filtered copies of types, valid as long as the analyser
+    std::vector<std::unique_ptr<Type>> copies;
 };
 
 }
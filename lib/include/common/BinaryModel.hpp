@@ -0,0 +1,350 @@
+#ifndef DEBUGTOCPP_BINARYMODEL_HPP
+#define DEBUGTOCPP_BINARYMODEL_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// Binary representation of extracted types written by BinaryClassDumper.
+// This header has no other dependencies so it can be copied into tools that only read the output.
+//
+// Everything is little-endian and referenced by offsets from the beginning of the buffer,
+// so the file can be mmap'ed and read in place. Offset 0 means "not present".
+// Records are copied as they are in memory, writer and reader refuse to work on big-endian hosts.
+//
+//   HeaderRecord                        at offset 0
+//   uint32_t[typeCount]                 offsets of top level TypeRecords, sorted by name
+//   string                              uint32_t length, characters, '\0'
+//   array                               count + offset of the first element, elements are consecutive
+//
+// Records containing 64 bit values are 8 byte aligned, everything else is 4 byte aligned.
+
+namespace debugtocpp {
+namespace binary {
+
+static const char MAGIC[4] = {'D', 'T', 'C', 'B'};
+static const uint32_t VERSION = 2;
+
+inline bool isLittleEndianHost() {
+    const uint16_t probe = 1;
+    unsigned char first;
+    memcpy(&first, &probe, sizeof(first));
+
+    return first == 1;
+}
+
+enum TypePtrFlags : uint32_t {
+    TYPEPTR_BASE = 1 << 0,
+    TYPEPTR_POINTER = 1 << 1,
+    TYPEPTR_CONSTANT = 1 << 2,
+    TYPEPTR_REFERENCE = 1 << 3,
+    TYPEPTR_ARRAY = 1 << 4,
+    TYPEPTR_VOLATILE = 1 << 5,
+    TYPEPTR_RVALUE_REFERENCE = 1 << 6
+};
+
+enum MethodFlags : uint32_t {
+    METHOD_STATIC = 1 << 0,
+    METHOD_VARIADIC = 1 << 1,
+    METHOD_VIRTUAL = 1 << 2,
+    METHOD_COMPILER_GENERATED = 1 << 3
+};
+
+struct HeaderRecord {
+    char magic[4];
+    uint32_t version;
+    uint32_t size;
+    uint32_t typeCount;
+    uint32_t types;
+};
+
+struct TypePtrRecord {
+    uint32_t type;
+    uint32_t flags;
+    int32_t arraySize;
+};
+
+struct ArgumentRecord {
+    uint32_t name;
+    uint32_t typePtr;
+};
+
+struct FieldRecord {
+    uint32_t name;
+    uint32_t typePtr;
+    int32_t offset;
+    uint32_t accessibility;
+    uint32_t isStatic;
+    uint32_t reserved;
+    uint64_t address;
+};
+
+struct MethodRecord {
+    uint32_t name;
+    uint32_t mangledName;
+    uint32_t returnType;
+    int32_t callType;
+    int32_t vftableOffset;
+    uint32_t flags;
+    uint32_t accessibility;
+    uint32_t argCount;
+    uint32_t args;
+    uint32_t reserved;
+    uint64_t address;
+};
+
+struct EnumeratorRecord {
+    uint32_t name;
+    uint32_t reserved;
+    int64_t value;
+};
+
+struct TemplateParameterRecord {
+    uint32_t name;
+    uint32_t typePtr;
+    uint32_t value;             // string, set for non-type parameters
+};
+
+struct TypeRecord {
+    uint32_t name;
+    uint32_t kind;              // TypeKind
+    uint32_t underlyingType;    // TypePtrRecord of enum or typedef
+    uint32_t baseCount;
+    uint32_t bases;             // uint32_t[] of strings
+    uint32_t fieldCount;
+    uint32_t fields;            // FieldRecord[]
+    uint32_t methodCount;
+    uint32_t methods;           // MethodRecord[] (all methods)
+    uint32_t definedCount;
+    uint32_t defined;           // uint32_t[] of MethodRecords (fully defined methods)
+    uint32_t dependentCount;
+    uint32_t dependents;        // uint32_t[] of strings
+    uint32_t nestedCount;
+    uint32_t nested;            // uint32_t[] of TypeRecords
+    uint32_t enumeratorCount;
+    uint32_t enumerators;       // EnumeratorRecord[]
+    uint32_t templateCount;
+    uint32_t templates;         // TemplateParameterRecord[]
+};
+
+static_assert(sizeof(HeaderRecord) == 20, "Unexpected HeaderRecord layout");
+static_assert(sizeof(TypePtrRecord) == 12, "Unexpected TypePtrRecord layout");
+static_assert(sizeof(ArgumentRecord) == 8, "Unexpected ArgumentRecord layout");
+static_assert(sizeof(FieldRecord) == 32, "Unexpected FieldRecord layout");
+static_assert(sizeof(MethodRecord) == 48, "Unexpected MethodRecord layout");
+static_assert(sizeof(EnumeratorRecord) == 16, "Unexpected EnumeratorRecord layout");
+static_assert(sizeof(TemplateParameterRecord) == 12, "Unexpected TemplateParameterRecord layout");
+static_assert(sizeof(TypeRecord) == 76, "Unexpected TypeRecord layout");
+
+// Reader
+
+class StringView {
+public:
+    StringView(const char *base, uint32_t offset) : base(base), offset(offset) {}
+
+    bool valid() const { return offset != 0; }
+    uint32_t size() const { return valid() ? *reinterpret_cast<const uint32_t *>(base + offset) : 0; }
+    const char *c_str() const { return valid() ? base + offset + sizeof(uint32_t) : ""; }
+    std::string str() const { return std::string(c_str(), size()); }
+
+    int compare(const char *other, size_t otherSize) const {
+        int result = memcmp(c_str(), other, std::min<size_t>(size(), otherSize));
+        if (result != 0) {
+            return result;
+        }
+
+        return size() < otherSize ? -1 : (size() > otherSize ? 1 : 0);
+    }
+
+private:
+    const char *base;
+    uint32_t offset;
+};
+
+template<typename T>
+class RecordView {
+public:
+    RecordView(const char *base, uint32_t offset) : base(base), offset(offset) {}
+
+    bool valid() const { return offset != 0; }
+    const T &record() const { return *reinterpret_cast<const T *>(base + offset); }
+
+protected:
+    const char *base;
+    uint32_t offset;
+
+    StringView string(uint32_t stringOffset) const { return StringView(base, stringOffset); }
+    uint32_t at(uint32_t arrayOffset, uint32_t i) const {
+        return reinterpret_cast<const uint32_t *>(base + arrayOffset)[i];
+    }
+};
+
+class TypePtrView : public RecordView<TypePtrRecord> {
+public:
+    using RecordView::RecordView;
+
+    StringView type() const { return string(record().type); }
+    bool isBaseType() const { return (record().flags & TYPEPTR_BASE) != 0; }
+    bool isPointer() const { return (record().flags & TYPEPTR_POINTER) != 0; }
+    bool isConstant() const { return (record().flags & TYPEPTR_CONSTANT) != 0; }
+    bool isVolatile() const { return (record().flags & TYPEPTR_VOLATILE) != 0; }
+    bool isReference() const { return (record().flags & TYPEPTR_REFERENCE) != 0; }
+    bool isRvalueReference() const { return (record().flags & TYPEPTR_RVALUE_REFERENCE) != 0; }
+    bool isArray() const { return (record().flags & TYPEPTR_ARRAY) != 0; }
+    int32_t arraySize() const { return record().arraySize; }
+};
+
+class ArgumentView : public RecordView<ArgumentRecord> {
+public:
+    using RecordView::RecordView;
+
+    StringView name() const { return string(record().name); }
+    TypePtrView typePtr() const { return TypePtrView(base, record().typePtr); }
+};
+
+class EnumeratorView : public RecordView<EnumeratorRecord> {
+public:
+    using RecordView::RecordView;
+
+    StringView name() const { return string(record().name); }
+    int64_t value() const { return record().value; }
+};
+
+class TemplateParameterView : public RecordView<TemplateParameterRecord> {
+public:
+    using RecordView::RecordView;
+
+    StringView name() const { return string(record().name); }
+    TypePtrView typePtr() const { return TypePtrView(base, record().typePtr); }
+    StringView value() const { return string(record().value); }
+};
+
+class FieldView : public RecordView<FieldRecord> {
+public:
+    using RecordView::RecordView;
+
+    StringView name() const { return string(record().name); }
+    TypePtrView typePtr() const { return TypePtrView(base, record().typePtr); }
+    int32_t offset() const { return record().offset; }
+    uint64_t address() const { return record().address; }
+    uint32_t accessibility() const { return record().accessibility; }
+    bool isStatic() const { return record().isStatic != 0; }
+};
+
+class MethodView : public RecordView<MethodRecord> {
+public:
+    using RecordView::RecordView;
+
+    StringView name() const { return string(record().name); }
+    StringView mangledName() const { return string(record().mangledName); }
+    TypePtrView returnType() const { return TypePtrView(base, record().returnType); }
+    uint64_t address() const { return record().address; }
+    int32_t callType() const { return record().callType; }
+    int32_t vftableOffset() const { return record().vftableOffset; }
+    uint32_t accessibility() const { return record().accessibility; }
+    bool isStatic() const { return (record().flags & METHOD_STATIC) != 0; }
+    bool isVariadic() const { return (record().flags & METHOD_VARIADIC) != 0; }
+    bool isVirtual() const { return (record().flags & METHOD_VIRTUAL) != 0; }
+    bool isCompilerGenerated() const { return (record().flags & METHOD_COMPILER_GENERATED) != 0; }
+
+    uint32_t argCount() const { return record().argCount; }
+    ArgumentView arg(uint32_t i) const {
+        return ArgumentView(base, record().args + i * static_cast<uint32_t>(sizeof(ArgumentRecord)));
+    }
+};
+
+class TypeView : public RecordView<TypeRecord> {
+public:
+    using RecordView::RecordView;
+
+    StringView name() const { return string(record().name); }
+    uint32_t kind() const { return record().kind; }
+    TypePtrView underlyingType() const { return TypePtrView(RecordView::base, record().underlyingType); }
+
+    uint32_t baseCount() const { return record().baseCount; }
+    StringView base(uint32_t i) const { return string(at(record().bases, i)); }
+
+    uint32_t fieldCount() const { return record().fieldCount; }
+    FieldView field(uint32_t i) const {
+        return FieldView(RecordView::base, record().fields + i * static_cast<uint32_t>(sizeof(FieldRecord)));
+    }
+
+    uint32_t methodCount() const { return record().methodCount; }
+    MethodView method(uint32_t i) const {
+        return MethodView(RecordView::base, record().methods + i * static_cast<uint32_t>(sizeof(MethodRecord)));
+    }
+
+    uint32_t definedMethodCount() const { return record().definedCount; }
+    MethodView definedMethod(uint32_t i) const { return MethodView(RecordView::base, at(record().defined, i)); }
+
+    uint32_t dependentCount() const { return record().dependentCount; }
+    StringView dependent(uint32_t i) const { return string(at(record().dependents, i)); }
+
+    uint32_t nestedCount() const { return record().nestedCount; }
+    TypeView nested(uint32_t i) const { return TypeView(RecordView::base, at(record().nested, i)); }
+
+    uint32_t enumeratorCount() const { return record().enumeratorCount; }
+    EnumeratorView enumerator(uint32_t i) const {
+        return EnumeratorView(RecordView::base,
+                              record().enumerators + i * static_cast<uint32_t>(sizeof(EnumeratorRecord)));
+    }
+
+    uint32_t templateParameterCount() const { return record().templateCount; }
+    TemplateParameterView templateParameter(uint32_t i) const {
+        return TemplateParameterView(RecordView::base,
+                                     record().templates + i * static_cast<uint32_t>(sizeof(TemplateParameterRecord)));
+    }
+};
+
+// Reads model from memory owned by the caller (e.g. mmap'ed file)
+class Model {
+public:
+    Model(const void *data, size_t size) : base(static_cast<const char *>(data)), size(size) {}
+
+    bool valid() const {
+        if (size < sizeof(HeaderRecord) || !isLittleEndianHost()) {
+            return false;
+        }
+
+        const HeaderRecord &header = this->header();
+        return memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == VERSION &&
+               header.size <= size && header.types + header.typeCount * sizeof(uint32_t) <= size;
+    }
+
+    uint32_t typeCount() const { return header().typeCount; }
+    TypeView type(uint32_t i) const { return TypeView(base, typeOffsets()[i]); }
+
+    // Binary search by name, returns invalid view when not found
+    TypeView find(const std::string &name) const {
+        const uint32_t *offsets = typeOffsets();
+        uint32_t low = 0, high = typeCount();
+
+        while (low < high) {
+            uint32_t mid = low + (high - low) / 2;
+            int result = TypeView(base, offsets[mid]).name().compare(name.data(), name.size());
+
+            if (result == 0) {
+                return TypeView(base, offsets[mid]);
+            } else if (result < 0) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+
+        return TypeView(base, 0);
+    }
+
+private:
+    const char *base;
+    size_t size;
+
+    const HeaderRecord &header() const { return *reinterpret_cast<const HeaderRecord *>(base); }
+    const uint32_t *typeOffsets() const { return reinterpret_cast<const uint32_t *>(base + header().types); }
+};
+
+}
+}
+
+#endif //DEBUGTOCPP_BINARYMODEL_HPP
@@ -6,13 +6,38 @@
 #include <string>
 #include <utility>
 #include <list>
-#include <retdec/pdbparser/pdb_file.h>
-
-using namespace retdec::pdbparser;
+#include <map>
+#include <vector>
 
 namespace debugtocpp {
 namespace types {
 
+// CodeView calling conventions
+enum CallingConvention {
+    CV_CALL_NEAR_C = 0x00,
+    CV_CALL_FAR_C = 0x01,
+    CV_CALL_NEAR_PASCAL = 0x02,
+    CV_CALL_FAR_PASCAL = 0x03,
+    CV_CALL_NEAR_FAST = 0x04,
+    CV_CALL_FAR_FAST = 0x05,
+    CV_CALL_SKIPPED = 0x06,
+    CV_CALL_NEAR_STD = 0x07,
+    CV_CALL_FAR_STD = 0x08,
+    CV_CALL_NEAR_SYS = 0x09,
+    CV_CALL_FAR_SYS = 0x0a,
+    CV_CALL_THISCALL = 0x0b,
+    CV_CALL_MIPSCALL = 0x0c,
+    CV_CALL_GENERIC = 0x0d,
+    CV_CALL_ALPHACALL = 0x0e,
+    CV_CALL_PPCCALL = 0x0f,
+    CV_CALL_SHCALL = 0x10,
+    CV_CALL_ARMCALL = 0x11,
+    CV_CALL_AM33CALL = 0x12,
+    CV_CALL_TRICALL = 0x13,
+    CV_CALL_SH5CALL = 0x14,
+    CV_CALL_M32RCALL = 0x15
+};
+
 // TODO: It is pdb only
 static std::map<int, std::string> callingConventionNames = {
         {CV_CALL_NEAR_C,      "__cdecl"},
@@ -44,13 +69,21 @@ enum Accessibility {
 
 static std::string accesibilityNames[] = {"none", "public", "private", "protected"};
 
+enum TypeKind {
+    CLASS, STRUCT, UNION, ENUM, TYPEDEF
+};
+
+static std::string typeKindNames[] = {"class", "struct", "union", "enum", "typedef"};
+
 class TypePtr {
 public:
     std::string type;
     bool isBaseType = false;
     bool isPointer = false;
     bool isConstant = false;
+    bool isVolatile = false;
     bool isReference = false;
+    bool isRvalueReference = false;
 
     bool isArray = false;
     int arraySize = 0;
@@ -64,7 +97,9 @@ public:
                isBaseType == rhs.isBaseType &&
                isPointer == rhs.isPointer &&
                isConstant == rhs.isConstant &&
+               isVolatile == rhs.isVolatile &&
                isReference == rhs.isReference &&
+               isRvalueReference == rhs.isRvalueReference &&
                isArray == rhs.isArray &&
                arraySize == rhs.arraySize;
     }
@@ -113,9 +148,24 @@ public:
     bool isCompilerGenerated = false;
 };
 
+struct Enumerator {
+    std::string name;
+    long value = 0;
+
+    Enumerator(const std::string &name, long value) : name(name), value(value) {}
+};
+
+// Arguments of template instantiation, value is set for non-type parameters
+struct TemplateParameter {
+    std::string name;
+    TypePtr * typePtr = nullptr;
+    std::string value;
+};
+
 class Type {
 public:
     std::string name;
+    TypeKind kind = TypeKind::CLASS;
     std::vector<Type *> baseTypes;
     std::vector<Field *> fields;
     std::vector<Method *> fullyDefinedMethods;
@@ -123,6 +173,10 @@ public:
     std::list<std::string> dependentTypes;
     std::vector<Type *> nestedTypes;
 
+    std::vector<Enumerator *> enumerators;
+    std::vector<TemplateParameter *> templateParameters;
+    TypePtr * underlyingType = nullptr; // Base type of enum or aliased type of typedef
+
     Type(std::string name) : name(std::move(name)) {}
 
     Type() {}
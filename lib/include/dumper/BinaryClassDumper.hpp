@@ -0,0 +1,44 @@
+#ifndef DEBUGTOCPP_BINARYCLASSDUMPER_HPP
+#define DEBUGTOCPP_BINARYCLASSDUMPER_HPP
+
+#include <map>
+#include <tuple>
+#include "ClassDumper.hpp"
+#include "common/BinaryModel.hpp"
+
+using namespace debugtocpp;
+
+namespace debugtocpp {
+
+// Writes types in format described in common/BinaryModel.hpp
+class BinaryClassDumper : public ClassDumper {
+public:
+    std::string dump(Type * cls, DumpConfig config) override;
+    std::vector<std::string> dump(std::vector<Type *> types, DumpConfig config) override;
+    void dump(std::vector<Type *> types, DumpConfig config, std::ostream &out) override;
+
+private:
+    std::string buffer;
+    std::map<std::string, uint32_t> strings;
+    std::map<std::tuple<std::string, uint32_t, int32_t>, uint32_t> typePtrs;
+
+    std::string build(const std::vector<Type *> &types);
+
+    uint32_t writeType(Type * type);
+    uint32_t writeMethods(const std::vector<Method *> &methods, std::map<Method *, uint32_t> &written);
+    binary::MethodRecord getMethodRecord(Method * method);
+    uint32_t writeTypePtr(TypePtr * typePtr);
+    uint32_t writeString(const std::string &str);
+    uint32_t writeArray(const std::vector<uint32_t> &offsets);
+
+    uint32_t reserve(size_t size, size_t alignment);
+
+    template<typename T>
+    void put(uint32_t offset, const T &record) {
+        memcpy(&buffer[offset], &record, sizeof(T));
+    }
+};
+
+}
+
+#endif //DEBUGTOCPP_BINARYCLASSDUMPER_HPP
@@ -2,6 +2,7 @@
 #define DEBUGTOCPP_CLASSDUMPER_H
 
 #include <string>
+#include <ostream>
 #include "common/DebugTypes.hpp"
 #include "utils/cxxopts.h"
 
@@ -12,6 +13,8 @@ namespace debugtocpp {
 struct DumpConfig {
     int indent = 4;
     bool json = false;
+    bool jsonLines = false;
+    bool binary = false;
     bool noCompilerGenerated = false;
     bool showAsPointers = false;
     bool addIncludesOrDeclarations = false;
@@ -23,8 +26,17 @@ struct DumpConfig {
 
 class ClassDumper {
 public:
+    virtual ~ClassDumper() = default;
+
     virtual std::string dump(Type * type, DumpConfig config) = 0;
     virtual std::vector<std::string> dump(std::vector<Type *> type, DumpConfig config) = 0;
+
+    // Writes all types to the stream as they are rendered
+    virtual void dump(std::vector<Type *> types, DumpConfig config, std::ostream &out) {
+        for (auto type : types) {
+            out << dump(type, config) << "\n";
+        }
+    }
 };
 
 }
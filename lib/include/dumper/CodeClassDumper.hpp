@@ -20,6 +20,8 @@ private:
     void dumpMethodArgs(std::stringstream &out, Method * method, bool pointers, DumpConfig config);
     std::string getName(std::string fullName, Type *cls);
     std::string printType(TypePtr * type, bool compilable);
+    std::string printDeclaration(TypePtr * type, const std::string &name, bool compilable);
+    void dumpAlias(std::stringstream &out, Type * cls, const std::string &displayName, DumpConfig config);
 };
 
 }
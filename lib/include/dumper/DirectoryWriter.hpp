@@ -0,0 +1,58 @@
+#ifndef DEBUGTOCPP_DIRECTORYWRITER_HPP
+#define DEBUGTOCPP_DIRECTORYWRITER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace debugtocpp {
+
+struct WriteStats {
+    size_t written = 0;
+    size_t unchanged = 0;
+    size_t failed = 0;
+};
+
+// Writes files on background threads while the caller keeps rendering.
+// Files with the same content are not touched so that build systems don't see them as modified.
+class DirectoryWriter {
+public:
+    DirectoryWriter(std::string directory, bool binary, unsigned threads = std::thread::hardware_concurrency());
+    ~DirectoryWriter();
+
+    void write(const std::string &fileName, std::string content);
+    WriteStats finish();
+
+private:
+    struct Worker {
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<std::pair<std::string, std::string>> queue;
+        bool done = false;
+    };
+
+    static const size_t maxQueued = 64;
+
+    std::string directory;
+    bool binary;
+    bool finished = false;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::atomic<size_t> written{0};
+    std::atomic<size_t> unchanged{0};
+    std::atomic<size_t> failed{0};
+
+    void run(Worker &worker);
+    void writeFile(const std::string &fileName, const std::string &content);
+    bool isUnchanged(const std::string &path, const std::string &content);
+};
+
+}
+
+#endif //DEBUGTOCPP_DIRECTORYWRITER_HPP
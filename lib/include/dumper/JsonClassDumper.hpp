@@ -2,11 +2,10 @@
 #define DEBUGTOCPP_JSONCLASSDUMPER_HPP
 
 #include "ClassDumper.hpp"
+#include "JsonWriter.hpp"
 #include "utils/cxxopts.h"
-#include "utils/json.hpp"
 
 using namespace debugtocpp;
-using json = nlohmann::json;
 
 namespace debugtocpp {
 
@@ -14,10 +13,11 @@ class JsonClassDumper : public ClassDumper {
 public:
     std::string dump(Type *cls, DumpConfig config) override;
     std::vector<std::string> dump(std::vector<Type *> type, DumpConfig config) override;
+    void dump(std::vector<Type *> types, DumpConfig config, std::ostream &out) override;
 
 private:
-    json dumpAsJsonObj(Type *cls);
-    void setType(json &obj, TypePtr * typePtr);
+    void dumpAsJsonObj(JsonWriter &writer, Type *cls);
+    void writeType(JsonWriter &writer, TypePtr * typePtr);
 };
 
 }
@@ -0,0 +1,49 @@
+#ifndef DEBUGTOCPP_JSONWRITER_HPP
+#define DEBUGTOCPP_JSONWRITER_HPP
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace debugtocpp {
+
+// Writes JSON straight to the output stream without building a document first.
+// Negative indent produces compact output.
+class JsonWriter {
+public:
+    JsonWriter(std::ostream &out, int indent) : out(out), indent(indent) {}
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    void key(const std::string &name);
+
+    void value(const std::string &value);
+    void value(const char * value);
+    void value(bool value);
+    void value(int value);
+    void value(long value);
+    void value(unsigned long value);
+
+private:
+    struct Scope {
+        bool empty = true;
+    };
+
+    std::ostream &out;
+    int indent;
+    std::vector<Scope> scopes;
+    bool afterKey = false;
+
+    void beginValue();
+    void begin(char bracket);
+    void end(char bracket);
+    void newLine(size_t depth);
+    void writeString(const std::string &str);
+};
+
+}
+
+#endif //DEBUGTOCPP_JSONWRITER_HPP
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <list>
+#include "common/AddressIndex.hpp"
 #include "common/DebugTypes.hpp"
 
 using namespace debugtocpp::types;
@@ -23,8 +24,21 @@ public:
     virtual std::list<std::string> getTypesList(bool showStructs) = 0;
     virtual std::vector<Field *> getAllGlobalVariables() = 0;
 
+    // Functions and global variables with their sizes, 0 when the size is unknown
+    virtual std::vector<AddressRange> getAddressRanges() = 0;
+
+    // Built from address ranges on the first use
+    const AddressIndex &getAddressIndex() {
+        if (addressIndex == nullptr) {
+            addressIndex = new AddressIndex(getAddressRanges());
+        }
+
+        return *addressIndex;
+    }
+
 protected:
     std::list<std::string> allDependentClasses;
+    AddressIndex * addressIndex = nullptr;
 };
 
 }
@@ -0,0 +1,36 @@
+#ifndef DEBUGTOCPP_MULTIEXTRACTOR_HPP
+#define DEBUGTOCPP_MULTIEXTRACTOR_HPP
+
+#include <map>
+#include <vector>
+#include "extractor/Extractor.hpp"
+
+namespace debugtocpp {
+
+// Combines already loaded extractors into one deduplicated set of types.
+// When a type is defined in several inputs, the first input containing it wins.
+class MultiExtractor : public Extractor {
+public:
+    explicit MultiExtractor(std::vector<Extractor *> extractors);
+
+    ExtractResult load(std::string filename, int image_base) override;
+
+    Type *getType(std::string name) override;
+    std::vector<Type *> getTypes(std::list<std::string> typesList) override;
+
+    std::list<std::string> getTypesList(bool showStructs) override;
+    std::vector<Field *> getAllGlobalVariables() override;
+    std::vector<AddressRange> getAddressRanges() override;
+
+private:
+    std::vector<Extractor *> extractors;
+
+    bool indexed = false;
+    std::map<std::string, Extractor *> owners;
+
+    void buildIndex();
+};
+
+}
+
+#endif //DEBUGTOCPP_MULTIEXTRACTOR_HPP
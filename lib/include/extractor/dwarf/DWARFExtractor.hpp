@@ -2,8 +2,12 @@
 #define DEBUGTOCPP_DWARFEXTRACTOR_HPP
 
 #include <string.h>
+#include <map>
+#include <set>
 
 #include "extractor/Extractor.hpp"
+#include "extractor/dwarf/DebugSections.hpp"
+#include "extractor/dwarf/SplitDwarf.hpp"
 #include <libelfin/elf/elf++.hh>
 #include <libelfin/dwarf/dwarf++.hh>
 
@@ -19,15 +23,75 @@ public:
 
     std::list<std::string> getTypesList(bool showStructs) override;
     std::vector<Field *> getAllGlobalVariables() override;
+    std::vector<AddressRange> getAddressRanges() override;
 
 private:
+    // Distinct layout of a type, copies with the same layout from other units share one entry.
+    // One copy of every distinct list of method declarations is kept to merge their methods
+    struct TypeDefinition {
+        ::dwarf::die node;
+        uint64_t hash;
+        size_t copies;
+        std::map<uint64_t, ::dwarf::die> methodVariants;
+    };
+
+    // Variable with static storage, declaration is the in-class declaration of static members
+    struct GlobalVariable {
+        ::dwarf::die node;
+        ::dwarf::die declaration;
+        std::string scope;
+        uint64_t address;
+    };
+
+    // Subprogram with code, scope is where the definition is, not the class of out of line methods
+    struct FunctionDefinition {
+        ::dwarf::die node;
+        std::string scope;
+    };
+
     ::elf::elf * elf;
     ::dwarf::dwarf * dwarf;
+    std::shared_ptr<DebugSections> sections;
+    std::string filename;
+    uint64_t imageBase = 0;
+    std::vector<SkeletonUnit> skeletons;
+    std::vector<::dwarf::dwarf *> splitUnits;
+
+    bool indexed = false;
+    std::map<std::string, std::vector<TypeDefinition>> typeIndex;
+    std::map<std::string, TypeDefinition> typedefIndex;
+    std::map<std::string, std::set<std::string>> qualifiedNames;
+    std::map<std::string, ::dwarf::die> methodDefinitions;
+    std::vector<GlobalVariable> globalVariables;
+    std::map<std::pair<const ::dwarf::unit *, ::dwarf::section_offset>, std::string> staticMemberNames;
+    std::map<std::pair<const ::dwarf::unit *, ::dwarf::section_offset>, uint64_t> staticMemberAddresses;
+    std::vector<FunctionDefinition> functionDefinitions;
+    std::map<std::pair<const ::dwarf::unit *, ::dwarf::section_offset>, std::string> methodNames;
+    std::set<std::string> reportedViolations;
+    std::map<std::pair<const ::dwarf::unit *, ::dwarf::section_offset>, TypePtr> typePtrCache;
+
+    void buildIndex();
+    bool indexSplitUnits();
+    void indexUnit(const ::dwarf::unit &unit, bool skeleton = false);
+    void indexNode(const ::dwarf::die &node, const std::string &scope);
+    void indexVariable(const ::dwarf::die &node, const std::string &scope);
+    bool getAddress(const ::dwarf::die &node, uint64_t &address);
+    void indexType(const ::dwarf::die &node, const std::string &scope);
+    void indexMethodDefinition(const ::dwarf::die &node);
+    void indexFunction(const ::dwarf::die &node, const std::string &scope);
+    const TypeDefinition * findDefinition(const std::string &name);
 
-    Type *getType(const ::dwarf::die &node, std::string &name);
-    ::dwarf::die findTypeNode(const ::dwarf::die &node, std::string &name);
+    Type *getType(const TypeDefinition &definition, std::string &name);
+    Method *getMethod(const ::dwarf::die &child, const ::dwarf::die &type);
     TypePtr * getTypePtr(const ::dwarf::die &die);
-    void updateMethods(std::vector<Method *> &methods, const ::dwarf::unit &unit, ::dwarf::section_offset offset);
+    const TypePtr &getCachedTypePtr(const ::dwarf::die &die);
+    TypePtr resolveTypePtr(const ::dwarf::die &die);
+    std::string getFunctionSignature(const ::dwarf::die &die, const std::string &declarator);
+    void getEnumerators(const ::dwarf::die &node, Type *type);
+    void updateMethods(std::vector<Method *> &methods);
+    std::string getFunctionName(const FunctionDefinition &function);
+    std::string getVariableName(const GlobalVariable &variable);
+    uint64_t getTypeSize(const ::dwarf::die &type);
 };
 
 }
@@ -0,0 +1,49 @@
+#ifndef DEBUGTOCPP_DEBUGSECTIONS_HPP
+#define DEBUGTOCPP_DEBUGSECTIONS_HPP
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <libelfin/elf/elf++.hh>
+#include <libelfin/dwarf/dwarf++.hh>
+
+namespace debugtocpp {
+namespace dwarf {
+
+// Replaces libelfin's ELF loader, debug sections compressed with SHF_COMPRESSED or stored as legacy
+// .zdebug_* sections are decompressed on first access and kept in memory
+class DebugSections : public ::dwarf::loader {
+public:
+    explicit DebugSections(const ::elf::elf &elf);
+
+    const void *load(::dwarf::section_type section, size_t *size_out) override;
+
+    // Data of section by its uncompressed name (e.g. ".debug_info"), nullptr when missing
+    const char *get(const std::string &name, size_t *size);
+
+    // Decompresses sections that are about to be read in parallel, so that big sections don't wait for each other
+    void prefetch(const std::vector<::dwarf::section_type> &sections);
+
+private:
+    struct Section {
+        std::once_flag loaded;
+        const char *data = nullptr;
+        size_t size = 0;
+        std::string buffer;
+    };
+
+    ::elf::elf elf;
+    std::mutex mutex;
+    std::map<std::string, std::unique_ptr<Section>> cache;
+
+    Section &getSection(const std::string &name);
+    void read(Section &section, const std::string &name);
+    std::string sectionName(::dwarf::section_type type);
+};
+
+}
+}
+
+#endif //DEBUGTOCPP_DEBUGSECTIONS_HPP
@@ -0,0 +1,35 @@
+#ifndef DEBUGTOCPP_SPLITDWARF_HPP
+#define DEBUGTOCPP_SPLITDWARF_HPP
+
+#include <string>
+#include <vector>
+#include <libelfin/elf/elf++.hh>
+#include <libelfin/dwarf/dwarf++.hh>
+#include "extractor/dwarf/DebugSections.hpp"
+
+namespace debugtocpp {
+namespace dwarf {
+
+// Compilation unit left in the binary by -gsplit-dwarf, its content is in a .dwo file or a .dwp package
+struct SkeletonUnit {
+    uint64_t unitOffset = 0;
+    std::string dwoName;
+    std::string compDir;
+    uint64_t dwoId = 0;
+    uint64_t addrBase = 0;
+};
+
+std::vector<SkeletonUnit> findSkeletonUnits(DebugSections &sections);
+
+// Signatures of units in .debug_types, libelfin only resolves them one by one with get_type_unit
+std::vector<uint64_t> findTypeUnitSignatures(DebugSections &sections);
+
+// Loads units referenced by skeletons in parallel, from <filename>.dwp when it exists or from .dwo files.
+// libelfin does not know GNU split DWARF forms, so units are converted to regular DWARF 4 while loading
+std::vector<::dwarf::dwarf *> loadSplitUnits(DebugSections &sections, const std::string &filename,
+                                             const std::vector<SkeletonUnit> &skeletons);
+
+}
+}
+
+#endif //DEBUGTOCPP_SPLITDWARF_HPP
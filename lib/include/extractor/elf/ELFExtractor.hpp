@@ -16,6 +16,7 @@ public:
     std::vector<Type *> getTypes(std::list<std::string> typesList) override;
     std::list<std::string> getTypesList(bool showStructs) override;
     std::vector<Field *> getAllGlobalVariables() override;
+    std::vector<AddressRange> getAddressRanges() override;
 
 private:
     Method *getMethod(::elf::sym * element);
@@ -25,6 +26,7 @@ private:
 
     ::elf::elf * elf;
     ::elf::symtab symtab;
+    uint64_t imageBase = 0;
     std::unique_ptr<retdec::demangler::CDemangler> demangler;
 };
 
@@ -0,0 +1,226 @@
+#ifndef DEBUGTOCPP_CODEVIEW_HPP
+#define DEBUGTOCPP_CODEVIEW_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace debugtocpp {
+namespace pdb {
+
+// Type index of the first record of TPI and IPI streams, lower indices are simple (builtin) types
+const uint32_t FIRST_TYPE_INDEX = 0x1000;
+
+enum LeafKind : uint16_t {
+    LF_MODIFIER = 0x1001,
+    LF_POINTER = 0x1002,
+    LF_PROCEDURE = 0x1008,
+    LF_MFUNCTION = 0x1009,
+    LF_ARGLIST = 0x1201,
+    LF_FIELDLIST = 0x1203,
+    LF_METHODLIST = 0x1206,
+
+    // Records of IPI stream
+    LF_FUNC_ID = 0x1601,
+    LF_MFUNC_ID = 0x1602,
+
+    // Members of field lists
+    LF_BCLASS = 0x1400,
+    LF_VBCLASS = 0x1401,
+    LF_IVBCLASS = 0x1402,
+    LF_INDEX = 0x1404,
+    LF_VFUNCTAB = 0x1409,
+    LF_ENUMERATE = 0x1502,
+    LF_MEMBER = 0x150d,
+    LF_STMEMBER = 0x150e,
+    LF_METHOD = 0x150f,
+    LF_NESTTYPE = 0x1510,
+    LF_ONEMETHOD = 0x1511,
+
+    LF_ARRAY = 0x1503,
+    LF_CLASS = 0x1504,
+    LF_STRUCTURE = 0x1505,
+    LF_UNION = 0x1506,
+    LF_ENUM = 0x1507,
+    LF_INTERFACE = 0x1519,
+
+    // Numeric leaves, values below LF_NUMERIC are stored directly
+    LF_NUMERIC = 0x8000,
+    LF_CHAR = 0x8000,
+    LF_SHORT = 0x8001,
+    LF_USHORT = 0x8002,
+    LF_LONG = 0x8003,
+    LF_ULONG = 0x8004,
+    LF_QUADWORD = 0x8009,
+    LF_UQUADWORD = 0x800a
+};
+
+enum SymbolKind : uint16_t {
+    S_END = 0x0006,
+    S_THUNK32 = 0x1102,
+    S_BLOCK32 = 0x1103,
+    S_WITH32 = 0x1104,
+    S_BPREL32 = 0x110b,
+    S_LDATA32 = 0x110c,
+    S_GDATA32 = 0x110d,
+    S_PUB32 = 0x110e,
+    S_LPROC32 = 0x110f,
+    S_GPROC32 = 0x1110,
+    S_REGREL32 = 0x1111,
+    S_SEPCODE = 0x1132,
+    S_LOCAL = 0x113e,
+    S_LPROC32_ID = 0x1146,
+    S_GPROC32_ID = 0x1147,
+    S_INLINESITE = 0x114d,
+    S_INLINESITE_END = 0x114e,
+    S_PROC_ID_END = 0x114f,
+    S_INLINESITE2 = 0x115d
+};
+
+// Module symbol streams start with it
+const uint32_t CV_SIGNATURE_C13 = 4;
+
+enum LocalFlags : uint16_t {
+    LOCAL_IS_PARAMETER = 0x1
+};
+
+enum ClassProperties : uint16_t {
+    PROPERTY_FORWARD_REFERENCE = 0x80,
+    PROPERTY_SCOPED = 0x100,
+    PROPERTY_HAS_UNIQUE_NAME = 0x200
+};
+
+enum ModifierFlags : uint16_t {
+    MODIFIER_CONST = 0x1
+};
+
+// Bits 2-4 of member attributes
+enum MethodProperty : uint16_t {
+    METHOD_VANILLA = 0,
+    METHOD_VIRTUAL = 1,
+    METHOD_STATIC = 2,
+    METHOD_FRIEND = 3,
+    METHOD_INTRO_VIRTUAL = 4,
+    METHOD_PURE_VIRTUAL = 5,
+    METHOD_PURE_INTRO_VIRTUAL = 6
+};
+
+// Bounds checked reader of little-endian record data, throws on truncated records
+class RecordReader {
+public:
+    RecordReader(const char *data, size_t size) : data(data), end(data + size) {}
+
+    uint8_t u8() { return read<uint8_t>(); }
+    uint16_t u16() { return read<uint16_t>(); }
+    uint32_t u32() { return read<uint32_t>(); }
+    int32_t i32() { return read<int32_t>(); }
+
+    int64_t numeric();
+    std::string string();
+
+    void skip(size_t size);
+    void skipPadding();
+    size_t remaining() const { return static_cast<size_t>(end - data); }
+    const char *position() const { return data; }
+
+private:
+    const char *data;
+    const char *end;
+
+    template<typename T>
+    T read() {
+        T value;
+        skip(sizeof(T));
+        memcpy(&value, data - sizeof(T), sizeof(T));
+        return value;
+    }
+};
+
+// LF_CLASS, LF_STRUCTURE, LF_INTERFACE, LF_UNION and LF_ENUM
+struct UdtRecord {
+    uint16_t kind = 0;
+    uint16_t properties = 0;
+    uint32_t fieldList = 0;
+    uint32_t underlyingType = 0;
+    uint64_t size = 0;
+    std::string name;
+    std::string uniqueName;
+
+    bool isForwardReference() const { return (properties & PROPERTY_FORWARD_REFERENCE) != 0; }
+};
+
+// Member of LF_FIELDLIST or entry of LF_METHODLIST, offset is the value of LF_ENUMERATE
+struct MemberRecord {
+    uint16_t kind = 0;
+    uint16_t attributes = 0;
+    uint32_t type = 0;
+    int64_t offset = 0;
+    int32_t vftableOffset = -1;
+    std::string name;
+
+    uint16_t getMethodProperty() const { return static_cast<uint16_t>((attributes >> 2) & 0x7); }
+};
+
+// LF_PROCEDURE and LF_MFUNCTION
+struct ProcedureRecord {
+    uint32_t returnType = 0;
+    uint32_t classType = 0;
+    uint32_t thisType = 0;
+    uint8_t callingConvention = 0;
+    uint32_t argumentList = 0;
+};
+
+// S_GPROC32, S_LPROC32 and their _ID variants
+struct ProcedureSymbol {
+    uint32_t length = 0;
+    uint32_t type = 0;
+    uint32_t offset = 0;
+    uint16_t segment = 0;
+    std::string name;
+};
+
+// S_GDATA32 and S_LDATA32
+struct DataSymbol {
+    uint32_t type = 0;
+    uint32_t offset = 0;
+    uint16_t segment = 0;
+    std::string name;
+};
+
+// LF_FUNC_ID and LF_MFUNC_ID, parent type is set only for member functions
+struct FunctionIdRecord {
+    uint32_t parentType = 0;
+    uint32_t type = 0;
+    std::string name;
+};
+
+bool isUdt(uint16_t kind);
+UdtRecord readUdt(uint16_t kind, RecordReader reader);
+ProcedureRecord readProcedure(uint16_t kind, RecordReader reader);
+FunctionIdRecord readFunctionId(uint16_t kind, RecordReader reader);
+
+// Reads one member and the padding after it
+MemberRecord readMember(RecordReader &reader);
+MemberRecord readMethodListEntry(RecordReader &reader);
+
+ProcedureSymbol readProcedureSymbol(RecordReader reader);
+DataSymbol readDataSymbol(RecordReader reader);
+
+// Symbols which are closed by S_END, S_PROC_ID_END or S_INLINESITE_END
+bool isScopeSymbol(uint16_t kind);
+bool isScopeEndSymbol(uint16_t kind);
+
+// Name of builtin type, e.g. 0x0074 is int and 0x0474 is int *
+std::string getSimpleTypeName(uint32_t index);
+bool isSimpleTypePointer(uint32_t index);
+
+// Size in bytes, pointers have the size of their mode
+uint32_t getSimpleTypeSize(uint32_t index);
+
+// Hash used by TPI and symbol hash tables
+uint32_t hashStringV1(const std::string &str);
+
+}
+}
+
+#endif //DEBUGTOCPP_CODEVIEW_HPP
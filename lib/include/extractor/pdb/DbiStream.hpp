@@ -0,0 +1,67 @@
+#ifndef DEBUGTOCPP_DBISTREAM_HPP
+#define DEBUGTOCPP_DBISTREAM_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "extractor/pdb/MsfFile.hpp"
+
+namespace debugtocpp {
+namespace pdb {
+
+struct ModuleInfo {
+    uint16_t symbolStream = 0;
+    uint32_t symbolBytes = 0;
+    std::string name;
+};
+
+// Debug information stream, lists modules and where the symbol streams are
+class DbiStream {
+public:
+    explicit DbiStream(const MsfFile &msf);
+
+    const std::vector<ModuleInfo> &getModules() const { return modules; }
+
+    uint16_t getGlobalSymbolStream() const { return header.globalSymbolStream; }
+    uint16_t getPublicSymbolStream() const { return header.publicSymbolStream; }
+    uint16_t getSymbolRecordStream() const { return header.symbolRecordStream; }
+
+    // Relative virtual address of segment:offset, -1 when the section is unknown
+    int64_t getRelativeAddress(uint16_t segment, uint32_t offset) const;
+
+private:
+    struct Header {
+        int32_t versionSignature;
+        uint32_t version;
+        uint32_t age;
+        uint16_t globalSymbolStream;
+        uint16_t buildNumber;
+        uint16_t publicSymbolStream;
+        uint16_t pdbDllVersion;
+        uint16_t symbolRecordStream;
+        uint16_t pdbDllRebuild;
+        int32_t moduleInfoSize;
+        int32_t sectionContributionSize;
+        int32_t sectionMapSize;
+        int32_t sourceInfoSize;
+        int32_t typeServerMapSize;
+        uint32_t mfcTypeServerIndex;
+        int32_t optionalDebugHeaderSize;
+        int32_t ecSubstreamSize;
+        uint16_t flags;
+        uint16_t machine;
+        uint32_t padding;
+    };
+
+    Header header{};
+    std::vector<ModuleInfo> modules;
+    std::vector<uint32_t> sectionAddresses;
+
+    void readModules(const MsfStream &stream, uint32_t offset);
+    void readSectionHeaders(const MsfFile &msf, const MsfStream &stream, uint32_t offset);
+};
+
+}
+}
+
+#endif //DEBUGTOCPP_DBISTREAM_HPP
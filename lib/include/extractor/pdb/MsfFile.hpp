@@ -0,0 +1,68 @@
+#ifndef DEBUGTOCPP_MSFFILE_HPP
+#define DEBUGTOCPP_MSFFILE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "extractor/Extractor.hpp"
+
+namespace debugtocpp {
+namespace pdb {
+
+// Streams with fixed indices
+enum StreamIndex : uint32_t {
+    STREAM_PDB = 1,
+    STREAM_TPI = 2,
+    STREAM_DBI = 3,
+    STREAM_IPI = 4
+};
+
+// Stream as a list of blocks of the mapped file, valid while the MsfFile exists
+class MsfStream {
+public:
+    MsfStream() = default;
+    MsfStream(const char *file, uint32_t blockSize, uint32_t size, const uint32_t *blocks)
+            : file(file), blockSize(blockSize), streamSize(size), blocks(blocks) {}
+
+    uint32_t size() const { return streamSize; }
+
+    // Points into the mapped file when the range is inside of one block,
+    // only ranges crossing blocks are copied into the buffer
+    const char *read(uint32_t offset, uint32_t size, std::vector<char> &buffer) const;
+
+private:
+    const char *file = nullptr;
+    uint32_t blockSize = 0;
+    uint32_t streamSize = 0;
+    const uint32_t *blocks = nullptr;
+};
+
+// Multi-Stream Format container of PDB files. The file is memory mapped and streams are read in place
+class MsfFile {
+public:
+    MsfFile() = default;
+    MsfFile(const MsfFile &) = delete;
+    MsfFile &operator=(const MsfFile &) = delete;
+    ~MsfFile();
+
+    ExtractResult open(const std::string &filename);
+
+    uint32_t getStreamCount() const { return static_cast<uint32_t>(streamSizes.size()); }
+
+    // Missing streams are empty
+    MsfStream getStream(uint32_t index) const;
+
+private:
+    const char *file = nullptr;
+    size_t fileSize = 0;
+    uint32_t blockSize = 0;
+
+    std::vector<char> directory;
+    std::vector<uint32_t> streamSizes;
+    std::vector<const uint32_t *> streamBlocks;
+};
+
+}
+}
+
+#endif //DEBUGTOCPP_MSFFILE_HPP
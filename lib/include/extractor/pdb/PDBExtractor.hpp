@@ -1,8 +1,14 @@
 #ifndef DEBUGTOCPP_PDBEXTRACTOR_HPP
 #define DEBUGTOCPP_PDBEXTRACTOR_HPP
 
+#include <map>
 #include "extractor/Extractor.hpp"
 #include "common/DebugTypes.hpp"
+#include "extractor/pdb/DbiStream.hpp"
+#include "extractor/pdb/MsfFile.hpp"
+#include "extractor/pdb/PublicSymbolTable.hpp"
+#include "extractor/pdb/SymbolTable.hpp"
+#include "extractor/pdb/TpiStream.hpp"
 
 namespace debugtocpp {
 namespace pdb {
@@ -15,29 +21,59 @@ public:
     std::vector<Type *> getTypes(std::list<std::string> typesList) override;
     std::list<std::string> getTypesList(bool showStructs) override;
     std::vector<Field *> getAllGlobalVariables();
+    std::vector<AddressRange> getAddressRanges() override;
 
 private:
-    retdec::pdbparser::PDBFile pdb;
+    MsfFile msf;
+    TpiStream * tpi = nullptr;
+    TpiStream * ipi = nullptr;
+    DbiStream * dbi = nullptr;
+    SymbolTable * symbols = nullptr;
+    PublicSymbolTable * publicSymbols = nullptr;
 
-    TypePtr * getReturnType(PDBTypeDef *type, int flags = 0);
-    Method *getMethod(PDBFunction * func);
-    Method *getMethod(PDBTypeFieldMember *fieldMember);
+    int imageBase = 0;
 
-    PDBTypeDef *findFullDeclaration(std::string name);
-};
+    // Resolved type descriptions by type index, classes are dependencies of every type using them
+    struct CachedTypePtr {
+        bool resolved = false;
+        bool isClass = false;
+        TypePtr typePtr;
+    };
+    std::vector<CachedTypePtr> typePtrCache;
 
-class PDBUniversalType {
-public:
-    std::string getName();
-    int getFieldListTypeId();
-    ePDBTypeClass getPDBType();
-    bool isType();
+    // Extracted classes and structs by type index, nullptr for other records
+    std::map<uint32_t, Type *> typeCache;
 
-    explicit PDBUniversalType(PDBTypeDef * typeDef);
+    // First definition of every class and struct seen by getTypesList, so --all doesn't look them up again
+    std::map<std::string, uint32_t> listedTypes;
 
-private:
-    PDBTypeClass *pdbClass = nullptr;
-    PDBTypeStruct *pdbStruct = nullptr;
+    // Defined method with its LF_MFUNCTION type and name without the class
+    struct ClassFunction {
+        const FunctionSymbol *symbol;
+        uint32_t type;
+        std::string name;
+    };
+
+    bool symbolsIndexed = false;
+    std::map<std::string, std::vector<ClassFunction>> classFunctions;
+    std::map<std::string, const VariableSymbol *> globalVariablesByName;
+
+    TpiStream &getTpi();
+    TpiStream &getIpi();
+    DbiStream &getDbi();
+    SymbolTable &getSymbols();
+    PublicSymbolTable &getPublicSymbols();
+    void indexSymbols();
+
+    Type *loadType(uint32_t index);
+    Type *extractType(uint32_t index);
+    TypePtr *getTypePtr(uint32_t index);
+    const CachedTypePtr &getCachedTypePtr(uint32_t index);
+    CachedTypePtr resolveTypePtr(uint32_t index);
+    uint64_t getTypeSize(uint32_t index);
+    Method *getMethod(const FunctionSymbol &function, uint32_t functionType);
+    Method *getMethod(const MemberRecord &member);
+    Method *getMethod(const std::string &name, const ProcedureRecord &procedure);
 };
 
 }
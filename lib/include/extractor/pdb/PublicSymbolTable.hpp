@@ -0,0 +1,73 @@
+#ifndef DEBUGTOCPP_PUBLICSYMBOLTABLE_HPP
+#define DEBUGTOCPP_PUBLICSYMBOLTABLE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "extractor/pdb/DbiStream.hpp"
+#include "extractor/pdb/MsfFile.hpp"
+
+namespace debugtocpp {
+namespace pdb {
+
+struct PublicSymbol {
+    std::string name;
+    uint64_t address = 0;
+    uint16_t segment = 0;
+    bool isFunction = false;
+};
+
+// S_PUB32 records of the public symbol stream. Only addresses are read up front, names are read when a
+// lookup needs them: by name through the hash table, by address with a binary search of the address map
+class PublicSymbolTable {
+public:
+    PublicSymbolTable(const MsfFile &msf, const DbiStream &dbi, uint64_t imageBase);
+
+    size_t size() const { return entries.size(); }
+
+    // Decorated name as in the PE export table, e.g. ?get@Foo@@UEBAHH@Z
+    bool findAddress(const std::string &name, uint64_t &address) const;
+
+    // Public symbol at or nearest below the address, public symbols have no size
+    bool findSymbol(uint64_t address, PublicSymbol &symbol) const;
+
+    // All public symbols in the order of addresses
+    void forEachSymbol(const std::function<void(const PublicSymbol &symbol)> &callback) const;
+
+private:
+    struct Header {
+        uint32_t symbolHashSize;
+        uint32_t addressMapSize;
+        uint32_t thunkCount;
+        uint32_t thunkSize;
+        uint16_t thunkTableSection;
+        uint16_t padding;
+        uint32_t thunkTableOffset;
+        uint32_t sectionCount;
+    };
+
+    // Address map sorted by address, record is an offset into the symbol record stream
+    struct Entry {
+        uint64_t address;
+        uint32_t record;
+    };
+
+    const DbiStream &dbi;
+    MsfStream records;
+    uint64_t imageBase;
+    std::vector<Entry> entries;
+
+    // Record offsets grouped by hash bucket, bucket i is hashRecords[bucketStarts[i]..bucketStarts[i + 1])
+    std::vector<uint32_t> bucketStarts;
+    std::vector<uint32_t> hashRecords;
+
+    void loadHash(const MsfStream &stream, uint32_t offset, uint32_t size);
+    void loadAddressMap(const MsfStream &stream, uint32_t offset, uint32_t size);
+    bool readSymbol(uint32_t record, PublicSymbol &symbol, bool withName) const;
+};
+
+}
+}
+
+#endif //DEBUGTOCPP_PUBLICSYMBOLTABLE_HPP
@@ -0,0 +1,56 @@
+#ifndef DEBUGTOCPP_SYMBOLTABLE_HPP
+#define DEBUGTOCPP_SYMBOLTABLE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "extractor/pdb/DbiStream.hpp"
+#include "extractor/pdb/MsfFile.hpp"
+
+namespace debugtocpp {
+namespace pdb {
+
+struct LocalSymbol {
+    std::string name;
+    uint32_t type = 0;
+};
+
+struct FunctionSymbol {
+    std::string name;
+    uint64_t address = 0;
+    uint32_t length = 0;
+    uint32_t type = 0;
+
+    // Type is LF_FUNC_ID or LF_MFUNC_ID of the IPI stream, as in S_GPROC32_ID and S_LPROC32_ID
+    bool isFunctionId = false;
+
+    // Parameters followed by other locals of the outermost scope when the compiler does not mark parameters
+    std::vector<LocalSymbol> arguments;
+};
+
+struct VariableSymbol {
+    std::string name;
+    uint64_t address = 0;
+    uint32_t type = 0;
+};
+
+// Functions from module symbol streams and global variables from the symbol record stream, both sorted by address
+class SymbolTable {
+public:
+    SymbolTable(const MsfFile &msf, const DbiStream &dbi, uint64_t imageBase);
+
+    const std::vector<FunctionSymbol> &getFunctions() const { return functions; }
+    const std::vector<VariableSymbol> &getGlobalVariables() const { return globalVariables; }
+
+private:
+    std::vector<FunctionSymbol> functions;
+    std::vector<VariableSymbol> globalVariables;
+
+    void loadModules(const MsfFile &msf, const DbiStream &dbi, uint64_t imageBase);
+    void loadGlobals(const MsfFile &msf, const DbiStream &dbi, uint64_t imageBase);
+};
+
+}
+}
+
+#endif //DEBUGTOCPP_SYMBOLTABLE_HPP
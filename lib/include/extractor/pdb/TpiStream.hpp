@@ -0,0 +1,90 @@
+#ifndef DEBUGTOCPP_TPISTREAM_HPP
+#define DEBUGTOCPP_TPISTREAM_HPP
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "extractor/pdb/CodeView.hpp"
+#include "extractor/pdb/MsfFile.hpp"
+
+namespace debugtocpp {
+namespace pdb {
+
+// Type records of TPI stream, IPI stream has the same layout
+class TpiStream {
+public:
+    TpiStream(const MsfFile &msf, uint32_t streamIndex);
+
+    uint32_t getFirstIndex() const { return header.typeIndexBegin; }
+    uint32_t getEndIndex() const { return header.typeIndexEnd; }
+
+    // Sequential walk over all records, callback gets record data without length and kind.
+    // Data is only valid during the callback
+    void forEachRecord(const std::function<void(uint32_t index, uint16_t kind, RecordReader reader)> &callback) const;
+
+    // Record by type index, walks from the nearest entry of the index offset buffer.
+    // Data is valid until the buffer is reused
+    RecordReader getRecord(uint32_t index, uint16_t &kind, std::vector<char> &buffer) const;
+
+    // Members of field list including its LF_INDEX continuations
+    void forEachMember(uint32_t fieldList, const std::function<void(const MemberRecord &member)> &callback) const;
+
+    // Full definition of class, struct, union or enum found through the hash stream, 0 when missing
+    uint32_t findType(const std::string &name);
+
+    // Full definition for forward references, other indices are returned unchanged
+    uint32_t resolveForwardReference(uint32_t index);
+
+private:
+    struct Header {
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t typeIndexBegin;
+        uint32_t typeIndexEnd;
+        uint32_t typeRecordBytes;
+
+        uint16_t hashStreamIndex;
+        uint16_t hashAuxStreamIndex;
+        uint32_t hashKeySize;
+        uint32_t hashBucketCount;
+
+        int32_t hashValueBufferOffset;
+        uint32_t hashValueBufferLength;
+        int32_t indexOffsetBufferOffset;
+        uint32_t indexOffsetBufferLength;
+        int32_t hashAdjBufferOffset;
+        uint32_t hashAdjBufferLength;
+    };
+
+    MsfStream stream;
+    MsfStream hashStream;
+    Header header{};
+
+    // Type indices grouped by hash bucket, bucket i is bucketIndices[bucketStarts[i]..bucketStarts[i + 1])
+    bool hashLoaded = false;
+    std::vector<uint32_t> bucketStarts;
+    std::vector<uint32_t> bucketIndices;
+
+    // Offsets of some records, sorted by index
+    struct IndexOffset {
+        uint32_t index;
+        uint32_t offset;
+    };
+    std::vector<IndexOffset> indexOffsets;
+
+    // First definition of every class, struct, union and enum, for names missing from the hash stream
+    bool namesIndexed = false;
+    std::unordered_map<std::string, uint32_t> definitionsByName;
+
+    void loadIndexOffsets();
+    void loadHash();
+    uint32_t findInBucket(const std::string &key, const std::string &name, const UdtRecord *reference);
+    uint32_t findLinear(const std::string &name, const UdtRecord *reference) const;
+    uint32_t findByName(const std::string &name);
+};
+
+}
+}
+
+#endif //DEBUGTOCPP_TPISTREAM_HPP
@@ -1,6 +1,7 @@
 #ifndef DEBUGTOCPP_UTILS_HPP
 #define DEBUGTOCPP_UTILS_HPP
 
+#include <cctype>
 #include <string>
 #include <list>
 #include <iostream>
@@ -33,6 +34,42 @@ inline std::list<std::string> split(const std::string &input, char delimiter) {
     return tokens;
 }
 
+// Splits command line into arguments, supports quoting with ' and "
+inline std::vector<std::string> splitArguments(const std::string &input) {
+    std::vector<std::string> arguments;
+    std::string current;
+    bool hasArgument = false;
+    char quote = 0;
+
+    for (char c : input) {
+        if (quote != 0) {
+            if (c == quote) {
+                quote = 0;
+            } else {
+                current += c;
+            }
+        } else if (c == '\'' || c == '"') {
+            quote = c;
+            hasArgument = true;
+        } else if (std::isspace(static_cast<unsigned char>(c))) {
+            if (hasArgument) {
+                arguments.push_back(current);
+                current.clear();
+                hasArgument = false;
+            }
+        } else {
+            current += c;
+            hasArgument = true;
+        }
+    }
+
+    if (hasArgument) {
+        arguments.push_back(current);
+    }
+
+    return arguments;
+}
+
 inline std::string join(std::vector<std::string> &source, std::string delim) {
     std::string out;
 
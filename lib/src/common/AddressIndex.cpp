@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <numeric>
+#include "common/AddressIndex.hpp"
+
+namespace debugtocpp {
+
+namespace {
+
+uint64_t getEnd(const AddressRange &range) {
+    uint64_t size = std::max<uint64_t>(range.size, 1);
+    return range.start + std::min(size, UINT64_MAX - range.start);
+}
+
+}
+
+AddressIndex::AddressIndex(std::vector<AddressRange> ranges) : ranges(std::move(ranges)) {
+    // Outer ranges first, so that ranges starting inside of them are pushed above them
+    std::vector<uint32_t> order(this->ranges.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        const AddressRange &first = this->ranges[a];
+        const AddressRange &second = this->ranges[b];
+        return first.start != second.start ? first.start < second.start : getEnd(first) > getEnd(second);
+    });
+
+    // Sweep keeping the stack of ranges containing the current position, every piece goes to the top one
+    std::vector<uint32_t> open;
+    uint64_t position = 0;
+
+    auto emit = [&](uint32_t range, uint64_t end) {
+        if (position < end) {
+            if (!intervals.empty() && intervals.back().range == range && intervals.back().end == position) {
+                intervals.back().end = end;
+            } else {
+                intervals.push_back({position, end, range});
+            }
+            position = end;
+        }
+    };
+
+    for (uint32_t index : order) {
+        const AddressRange &range = this->ranges[index];
+
+        while (!open.empty() && getEnd(this->ranges[open.back()]) <= range.start) {
+            emit(open.back(), getEnd(this->ranges[open.back()]));
+            open.pop_back();
+        }
+
+        // The same range from several sources is kept once, the first one wins
+        if (!open.empty()) {
+            const AddressRange &top = this->ranges[open.back()];
+            if (top.start == range.start && getEnd(top) == getEnd(range)) {
+                continue;
+            }
+
+            emit(open.back(), range.start);
+        }
+
+        position = std::max(position, range.start);
+        open.push_back(index);
+    }
+
+    while (!open.empty()) {
+        emit(open.back(), getEnd(this->ranges[open.back()]));
+        open.pop_back();
+    }
+}
+
+const AddressRange *AddressIndex::find(uint64_t address) const {
+    auto it = std::upper_bound(intervals.begin(), intervals.end(), address, [](uint64_t value, const Interval &interval) {
+        return value < interval.start;
+    });
+
+    if (it == intervals.begin() || address >= (it - 1)->end) {
+        return nullptr;
+    }
+
+    return &ranges[(it - 1)->range];
+}
+
+std::vector<const AddressRange *> AddressIndex::find(const std::vector<uint64_t> &addresses) const {
+    std::vector<const AddressRange *> result(addresses.size(), nullptr);
+
+    std::vector<size_t> order(addresses.size());
+    std::iota(order.begin(), order.end(), 0);
+    if (!std::is_sorted(addresses.begin(), addresses.end())) {
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return addresses[a] < addresses[b]; });
+    }
+
+    // Search continues from the interval of the previous address
+    auto it = intervals.begin();
+    for (size_t i : order) {
+        uint64_t address = addresses[i];
+
+        it = std::upper_bound(it, intervals.end(), address, [](uint64_t value, const Interval &interval) {
+            return value < interval.start;
+        });
+
+        if (it != intervals.begin() && address < (it - 1)->end) {
+            result[i] = &ranges[(it - 1)->range];
+        }
+    }
+
+    return result;
+}
+
+}
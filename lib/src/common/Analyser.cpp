@@ -3,36 +3,42 @@
 #include "common/Analyser.hpp"
 
 void Analyser::process(std::vector<Type *> &types) {
-    for (auto &type : types) {
-        if (!process(type)) {
-            types.erase(std::remove(types.begin(), types.end(), type), types.end());
+    std::vector<Type *> kept;
+    kept.reserve(types.size());
+
+    for (Type * type : types) {
+        if (process(type)) {
+            kept.push_back(type);
         }
     }
+
+    types = std::move(kept);
 }
 
-bool Analyser::process(Type *type) {
+// Extractors may return cached types, so methods are removed from a copy that replaces the type
+bool Analyser::process(Type *&type) {
     if (config.noCompilerGenerated && isCompilerGenerated(type)) {
         return false;
     }
 
-    auto it = std::begin(type->allMethods);
-
-    while (it != std::end(type->allMethods)) {
-        Method * method = *it.base();
-
+    std::vector<Method *> methods;
+    for (Method * method : type->allMethods) {
         bool compilerGenerated = isCompilerGenerated(method);
         if (compilerGenerated) {
             method->isCompilerGenerated = true;
-            if (config.noCompilerGenerated) {
-                it = type->allMethods.erase(it);
-            }
         }
 
         if (!compilerGenerated || !config.noCompilerGenerated) {
-            ++it;
+            methods.push_back(method);
         }
     }
 
+    if (methods.size() != type->allMethods.size()) {
+        copies.emplace_back(new Type(*type));
+        type = copies.back().get();
+        type->allMethods = std::move(methods);
+    }
+
     return true;
 }
 
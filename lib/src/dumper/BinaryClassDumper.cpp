@@ -0,0 +1,301 @@
+#include <algorithm>
+#include "dumper/BinaryClassDumper.hpp"
+
+namespace debugtocpp {
+
+using namespace debugtocpp::binary;
+
+std::vector<std::string> BinaryClassDumper::dump(std::vector<Type *> types, DumpConfig config) {
+    std::vector<std::string> out;
+
+    if (config.toDirectory) {
+        out.reserve(types.size());
+        for (auto type : types) {
+            out.push_back(dump(type, config));
+        }
+    } else {
+        out.push_back(build(types));
+    }
+
+    return out;
+}
+
+void BinaryClassDumper::dump(std::vector<Type *> types, DumpConfig config, std::ostream &out) {
+    out << build(types);
+}
+
+std::string BinaryClassDumper::dump(Type *cls, DumpConfig config) {
+    return build({cls});
+}
+
+std::string BinaryClassDumper::build(const std::vector<Type *> &types) {
+    if (!isLittleEndianHost()) {
+        throw std::string("Binary output is only supported on little-endian hosts");
+    }
+
+    buffer.clear();
+    strings.clear();
+    typePtrs.clear();
+
+    uint32_t headerOffset = reserve(sizeof(HeaderRecord), 8);
+
+    std::vector<std::pair<std::string, uint32_t>> written;
+    written.reserve(types.size());
+    for (auto type : types) {
+        written.emplace_back(type->name, writeType(type));
+    }
+
+    // Sorted so that readers can binary search by name
+    std::stable_sort(written.begin(), written.end(), [](const std::pair<std::string, uint32_t> &a,
+                                                        const std::pair<std::string, uint32_t> &b) {
+        return a.first < b.first;
+    });
+
+    std::vector<uint32_t> offsets;
+    offsets.reserve(written.size());
+    for (auto &type : written) {
+        offsets.push_back(type.second);
+    }
+
+    HeaderRecord header{};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.typeCount = static_cast<uint32_t>(offsets.size());
+    header.types = writeArray(offsets);
+    header.size = static_cast<uint32_t>(buffer.size());
+    put(headerOffset, header);
+
+    std::string out;
+    out.swap(buffer);
+    return out;
+}
+
+uint32_t BinaryClassDumper::writeType(Type *type) {
+    TypeRecord record{};
+    record.name = writeString(type->name);
+    record.kind = type->kind;
+    record.underlyingType = writeTypePtr(type->underlyingType);
+
+    std::vector<EnumeratorRecord> enumerators;
+    for (auto enumerator : type->enumerators) {
+        EnumeratorRecord enumeratorRecord{};
+        enumeratorRecord.name = writeString(enumerator->name);
+        enumeratorRecord.value = enumerator->value;
+        enumerators.push_back(enumeratorRecord);
+    }
+
+    record.enumeratorCount = static_cast<uint32_t>(enumerators.size());
+    if (!enumerators.empty()) {
+        record.enumerators = reserve(enumerators.size() * sizeof(EnumeratorRecord), 8);
+        for (size_t i = 0; i < enumerators.size(); i++) {
+            put(static_cast<uint32_t>(record.enumerators + i * sizeof(EnumeratorRecord)), enumerators[i]);
+        }
+    }
+
+    std::vector<TemplateParameterRecord> templates;
+    for (auto parameter : type->templateParameters) {
+        TemplateParameterRecord parameterRecord{};
+        parameterRecord.name = writeString(parameter->name);
+        parameterRecord.typePtr = writeTypePtr(parameter->typePtr);
+        parameterRecord.value = parameter->value.empty() ? 0 : writeString(parameter->value);
+        templates.push_back(parameterRecord);
+    }
+
+    record.templateCount = static_cast<uint32_t>(templates.size());
+    if (!templates.empty()) {
+        record.templates = reserve(templates.size() * sizeof(TemplateParameterRecord), 4);
+        for (size_t i = 0; i < templates.size(); i++) {
+            put(static_cast<uint32_t>(record.templates + i * sizeof(TemplateParameterRecord)), templates[i]);
+        }
+    }
+
+    std::vector<uint32_t> bases;
+    for (auto baseType : type->baseTypes) {
+        bases.push_back(writeString(baseType->name));
+    }
+    record.baseCount = static_cast<uint32_t>(bases.size());
+    record.bases = writeArray(bases);
+
+    std::vector<uint32_t> dependents;
+    for (auto &dependent : type->dependentTypes) {
+        dependents.push_back(writeString(dependent));
+    }
+    record.dependentCount = static_cast<uint32_t>(dependents.size());
+    record.dependents = writeArray(dependents);
+
+    std::vector<uint32_t> nested;
+    for (auto nestedType : type->nestedTypes) {
+        nested.push_back(writeType(nestedType));
+    }
+    record.nestedCount = static_cast<uint32_t>(nested.size());
+    record.nested = writeArray(nested);
+
+    std::vector<FieldRecord> fields;
+    for (auto field : type->fields) {
+        FieldRecord fieldRecord{};
+        fieldRecord.name = writeString(field->name);
+        fieldRecord.typePtr = writeTypePtr(field->typePtr);
+        fieldRecord.offset = field->offset;
+        fieldRecord.address = field->address;
+        fieldRecord.accessibility = field->accessibility;
+        fieldRecord.isStatic = field->isStatic;
+        fields.push_back(fieldRecord);
+    }
+
+    record.fieldCount = static_cast<uint32_t>(fields.size());
+    if (!fields.empty()) {
+        record.fields = reserve(fields.size() * sizeof(FieldRecord), 8);
+        for (size_t i = 0; i < fields.size(); i++) {
+            put(static_cast<uint32_t>(record.fields + i * sizeof(FieldRecord)), fields[i]);
+        }
+    }
+
+    // Fully defined methods usually point to the same objects as allMethods, so reuse written records
+    std::map<Method *, uint32_t> writtenMethods;
+    record.methodCount = static_cast<uint32_t>(type->allMethods.size());
+    record.methods = writeMethods(type->allMethods, writtenMethods);
+
+    std::vector<uint32_t> defined;
+    for (auto method : type->fullyDefinedMethods) {
+        if (!writtenMethods.count(method)) {
+            writeMethods({method}, writtenMethods);
+        }
+
+        defined.push_back(writtenMethods[method]);
+    }
+    record.definedCount = static_cast<uint32_t>(defined.size());
+    record.defined = writeArray(defined);
+
+    uint32_t offset = reserve(sizeof(TypeRecord), 4);
+    put(offset, record);
+
+    return offset;
+}
+
+uint32_t BinaryClassDumper::writeMethods(const std::vector<Method *> &methods, std::map<Method *, uint32_t> &written) {
+    if (methods.empty()) {
+        return 0;
+    }
+
+    std::vector<MethodRecord> records;
+    records.reserve(methods.size());
+    for (auto method : methods) {
+        records.push_back(getMethodRecord(method));
+    }
+
+    uint32_t offset = reserve(records.size() * sizeof(MethodRecord), 8);
+    for (size_t i = 0; i < records.size(); i++) {
+        auto recordOffset = static_cast<uint32_t>(offset + i * sizeof(MethodRecord));
+        put(recordOffset, records[i]);
+        written[methods[i]] = recordOffset;
+    }
+
+    return offset;
+}
+
+MethodRecord BinaryClassDumper::getMethodRecord(Method *method) {
+    std::vector<ArgumentRecord> args;
+    for (auto arg : method->args) {
+        ArgumentRecord argRecord{};
+        argRecord.name = writeString(arg->name);
+        argRecord.typePtr = writeTypePtr(arg->typePtr);
+        args.push_back(argRecord);
+    }
+
+    MethodRecord record{};
+    record.name = writeString(method->name);
+    record.mangledName = writeString(method->mangledName);
+    record.returnType = writeTypePtr(method->returnType);
+    record.address = method->address;
+    record.callType = method->callType;
+    record.vftableOffset = method->vftableOffset;
+    record.accessibility = method->accessibility;
+
+    record.flags = (method->isStatic ? METHOD_STATIC : 0) |
+                   (method->isVariadic ? METHOD_VARIADIC : 0) |
+                   (method->isVirtual ? METHOD_VIRTUAL : 0) |
+                   (method->isCompilerGenerated ? METHOD_COMPILER_GENERATED : 0);
+
+    record.argCount = static_cast<uint32_t>(args.size());
+    if (!args.empty()) {
+        record.args = reserve(args.size() * sizeof(ArgumentRecord), 4);
+        for (size_t i = 0; i < args.size(); i++) {
+            put(static_cast<uint32_t>(record.args + i * sizeof(ArgumentRecord)), args[i]);
+        }
+    }
+
+    return record;
+}
+
+// Identical type descriptions are stored only once
+uint32_t BinaryClassDumper::writeTypePtr(TypePtr *typePtr) {
+    if (typePtr == nullptr) {
+        return 0;
+    }
+
+    uint32_t flags = (typePtr->isBaseType ? TYPEPTR_BASE : 0) |
+                     (typePtr->isPointer ? TYPEPTR_POINTER : 0) |
+                     (typePtr->isConstant ? TYPEPTR_CONSTANT : 0) |
+                     (typePtr->isReference ? TYPEPTR_REFERENCE : 0) |
+                     (typePtr->isArray ? TYPEPTR_ARRAY : 0) |
+                     (typePtr->isVolatile ? TYPEPTR_VOLATILE : 0) |
+                     (typePtr->isRvalueReference ? TYPEPTR_RVALUE_REFERENCE : 0);
+
+    auto key = std::make_tuple(typePtr->type, flags, static_cast<int32_t>(typePtr->arraySize));
+    auto it = typePtrs.find(key);
+    if (it != typePtrs.end()) {
+        return it->second;
+    }
+
+    TypePtrRecord record{};
+    record.type = writeString(typePtr->type);
+    record.flags = flags;
+    record.arraySize = typePtr->arraySize;
+
+    uint32_t offset = reserve(sizeof(TypePtrRecord), 4);
+    put(offset, record);
+
+    typePtrs[key] = offset;
+    return offset;
+}
+
+// Strings are deduplicated, type names repeat a lot
+uint32_t BinaryClassDumper::writeString(const std::string &str) {
+    auto it = strings.find(str);
+    if (it != strings.end()) {
+        return it->second;
+    }
+
+    uint32_t offset = reserve(sizeof(uint32_t) + str.size() + 1, 4);
+    auto size = static_cast<uint32_t>(str.size());
+    put(offset, size);
+    memcpy(&buffer[offset + sizeof(uint32_t)], str.data(), str.size());
+
+    strings[str] = offset;
+    return offset;
+}
+
+uint32_t BinaryClassDumper::writeArray(const std::vector<uint32_t> &offsets) {
+    if (offsets.empty()) {
+        return 0;
+    }
+
+    uint32_t offset = reserve(offsets.size() * sizeof(uint32_t), 4);
+    memcpy(&buffer[offset], offsets.data(), offsets.size() * sizeof(uint32_t));
+
+    return offset;
+}
+
+// Appends zeroed space and returns its offset
+uint32_t BinaryClassDumper::reserve(size_t size, size_t alignment) {
+    size_t offset = (buffer.size() + alignment - 1) / alignment * alignment;
+    if (offset + size > UINT32_MAX) {
+        throw std::string("Binary output is larger than 4 GiB");
+    }
+
+    buffer.resize(offset + size, '\0');
+
+    return static_cast<uint32_t>(offset);
+}
+
+}
@@ -59,7 +59,29 @@ std::string CodeClassDumper::dump(Type *cls, DumpConfig config) {
     }
 
     std::string classDisplayName = config.compilable ? compilableClassName : cls->name;
-    out << "class " << classDisplayName.c_str();
+
+    if (cls->kind == TypeKind::ENUM || cls->kind == TypeKind::TYPEDEF) {
+        dumpAlias(out, cls, classDisplayName, config);
+
+        if (config.addGuards) {
+            out << "#endif\n\n";
+        }
+
+        return out.str();
+    }
+
+    if (!cls->templateParameters.empty()) {
+        out << "// Template parameters: ";
+        for (size_t i = 0; i < cls->templateParameters.size(); i++) {
+            TemplateParameter *parameter = cls->templateParameters[i];
+            out << (i != 0 ? ", " : "") << parameter->name << " = "
+                << (!parameter->value.empty() || parameter->typePtr == nullptr ?
+                    parameter->value : printType(parameter->typePtr, false));
+        }
+        out << "\n";
+    }
+
+    out << typeKindNames[cls->kind] << " " << classDisplayName.c_str();
 
     // Show base class
     if (!cls->baseTypes.empty()) {
@@ -91,10 +113,9 @@ std::string CodeClassDumper::dump(Type *cls, DumpConfig config) {
         // [static] TYPE NAME;
         out << indent
             << (field->isStatic ? "static " : "")
-            << printType(field->typePtr, config.compilable)
-            << " "
-            << (config.showAsPointers && field->isStatic ? "* " : "")
-            << getName(field->name, cls)
+            << printDeclaration(field->typePtr,
+                                (config.showAsPointers && field->isStatic ? "* " : "") + getName(field->name, cls),
+                                config.compilable)
             << (field->typePtr->isArray ? "[" + std::to_string(field->typePtr->arraySize) + "]" : "")
             << ";\n";
     }
@@ -209,19 +230,18 @@ void CodeClassDumper::dumpPointers(std::stringstream &out, Type *cls, DumpConfig
 void CodeClassDumper::dumpMethodArgs(std::stringstream &out, Method *method, bool pointers, DumpConfig config) {
     for (int i = 0; i < method->args.size(); i++) {
         Argument *arg = method->args[i];
+        std::string name = arg->name;
 
-        // Skip 'this' argument
-        if (arg->name == "this") {
+        // Skip 'this' argument, types can be shared by extractors so it is renamed only here
+        if (name == "this") {
             if (pointers) {
-                arg->name = "self";
+                name = "self";
             } else {
                 continue;
             }
         }
 
-        out << printType(arg->typePtr, config.compilable)
-            << (!arg->name.empty() ? " " : "")
-            << arg->name;
+        out << printDeclaration(arg->typePtr, name, config.compilable);
 
         // Add comma between every argument
         if (i != method->args.size() - 1) {
@@ -235,7 +255,44 @@ std::string CodeClassDumper::printType(TypePtr * typePtr, bool compilable) {
     if (compilable && !typePtr->isBaseType)
         name = clearString(name);
 
-    return (typePtr->isConstant ? std::string("const ") : "") + name + (typePtr->isReference ? "&" : "") + (typePtr->isPointer ? " *" : "");
+    return (typePtr->isConstant ? std::string("const ") : "") + (typePtr->isVolatile ? "volatile " : "") + name +
+           (typePtr->isReference ? "&" : "") + (typePtr->isRvalueReference ? "&&" : "") + (typePtr->isPointer ? " *" : "");
+}
+
+// Name of function pointer goes inside of its type, "void (*name)(int)"
+std::string CodeClassDumper::printDeclaration(TypePtr *typePtr, const std::string &name, bool compilable) {
+    std::string type = printType(typePtr, compilable);
+
+    size_t position = type.find("(*)");
+    if (position != std::string::npos) {
+        return type.insert(position + 2, name);
+    }
+
+    return type + (!name.empty() ? " " : "") + name;
+}
+
+void CodeClassDumper::dumpAlias(std::stringstream &out, Type *cls, const std::string &displayName,
+                                DumpConfig config) {
+    std::string indent = std::string(static_cast<unsigned long>(config.indent), ' ');
+
+    if (cls->kind == TypeKind::TYPEDEF) {
+        // typedef TYPE NAME;
+        out << "typedef " << printDeclaration(cls->underlyingType, displayName, config.compilable) << ";\n";
+        return;
+    }
+
+    // enum NAME : TYPE {
+    out << "enum " << displayName;
+    if (cls->underlyingType != nullptr) {
+        out << " : " << printType(cls->underlyingType, config.compilable);
+    }
+    out << " {\n";
+
+    for (auto enumerator : cls->enumerators) {
+        out << indent << enumerator->name << " = " << enumerator->value << ",\n";
+    }
+
+    out << "};\n";
 }
 
 std::string CodeClassDumper::getName(std::string fullName, Type *cls) {
@@ -0,0 +1,114 @@
+#include <fstream>
+#include <functional>
+#include "dumper/DirectoryWriter.hpp"
+
+namespace debugtocpp {
+
+DirectoryWriter::DirectoryWriter(std::string directory, bool binary, unsigned threads)
+        : directory(std::move(directory)), binary(binary) {
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    for (unsigned i = 0; i < threads; i++) {
+        workers.emplace_back(new Worker);
+    }
+
+    for (auto &worker : workers) {
+        Worker &w = *worker;
+        worker->thread = std::thread([this, &w] { run(w); });
+    }
+}
+
+DirectoryWriter::~DirectoryWriter() {
+    finish();
+}
+
+void DirectoryWriter::write(const std::string &fileName, std::string content) {
+    // The same file always goes to the same worker, so later writes can't be overtaken by earlier ones
+    Worker &worker = *workers[std::hash<std::string>()(fileName) % workers.size()];
+
+    std::unique_lock<std::mutex> lock(worker.mutex);
+    worker.condition.wait(lock, [&worker] { return worker.queue.size() < maxQueued; });
+
+    worker.queue.emplace_back(fileName, std::move(content));
+    worker.condition.notify_all();
+}
+
+WriteStats DirectoryWriter::finish() {
+    if (!finished) {
+        finished = true;
+
+        for (auto &worker : workers) {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            worker->done = true;
+            worker->condition.notify_all();
+        }
+
+        for (auto &worker : workers) {
+            worker->thread.join();
+        }
+    }
+
+    WriteStats stats;
+    stats.written = written;
+    stats.unchanged = unchanged;
+    stats.failed = failed;
+
+    return stats;
+}
+
+void DirectoryWriter::run(Worker &worker) {
+    while (true) {
+        std::pair<std::string, std::string> job;
+
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            worker.condition.wait(lock, [&worker] { return !worker.queue.empty() || worker.done; });
+
+            if (worker.queue.empty()) {
+                return;
+            }
+
+            job = std::move(worker.queue.front());
+            worker.queue.pop_front();
+            worker.condition.notify_all();
+        }
+
+        writeFile(job.first, job.second);
+    }
+}
+
+void DirectoryWriter::writeFile(const std::string &fileName, const std::string &content) {
+    std::string path = directory + "/" + fileName;
+
+    if (isUnchanged(path, content)) {
+        unchanged++;
+        return;
+    }
+
+    std::ofstream file(path, binary ? std::ios::out | std::ios::binary : std::ios::out);
+    file << content;
+    file.close();
+
+    if (file.fail()) {
+        failed++;
+    } else {
+        written++;
+    }
+}
+
+bool DirectoryWriter::isUnchanged(const std::string &path, const std::string &content) {
+    std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file.is_open() || static_cast<size_t>(file.tellg()) != content.size()) {
+        return false;
+    }
+
+    std::string existing(content.size(), '\0');
+    file.seekg(0);
+    file.read(&existing[0], existing.size());
+
+    return file.good() && existing == content;
+}
+
+}
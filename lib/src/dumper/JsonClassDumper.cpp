@@ -1,92 +1,227 @@
 #include <sstream>
-#include "utils/json.hpp"
 #include "dumper/JsonClassDumper.hpp"
 #include "utils/cxxopts.h"
 
-using json = nlohmann::json;
-
 std::vector<std::string> JsonClassDumper::dump(std::vector<Type *> types, DumpConfig config) {
     std::vector<std::string> out;
 
     if (config.toDirectory) {
+        out.reserve(types.size());
         for (auto type : types) {
-            out.push_back(dumpAsJsonObj(type).dump(config.indent, ' ', false));
+            out.push_back(dump(type, config));
         }
     } else {
-        json js;
+        std::stringstream ss;
+        JsonWriter writer(ss, config.indent);
 
-        int i = 0;
+        writer.beginArray();
         for (auto type : types) {
-            js[i++] = dumpAsJsonObj(type);
+            dumpAsJsonObj(writer, type);
         }
+        writer.endArray();
 
-        out.push_back(js.dump(config.indent, ' ', false));
+        out.push_back(ss.str());
     }
 
     return out;
 }
 
-std::string JsonClassDumper::dump(Type *cls, DumpConfig config) {
-    return dumpAsJsonObj(cls).dump(config.indent, ' ', false);
-}
-
-json JsonClassDumper::dumpAsJsonObj(Type *cls) {
-    json js;
+void JsonClassDumper::dump(std::vector<Type *> types, DumpConfig config, std::ostream &out) {
+    // One compact object per line
+    if (config.jsonLines) {
+        for (auto type : types) {
+            JsonWriter writer(out, -1);
+            dumpAsJsonObj(writer, type);
+            out << "\n";
+        }
 
-    js["className"] = cls->name;
-    if (!cls->baseTypes.empty()) {
-        js["baseClass"] = cls->baseTypes[0]->name;
+        return;
     }
 
-    for (int i = 0; i < cls->nestedTypes.size(); i++) {
-        js["nestedTypes"][i] = dumpAsJsonObj(cls->nestedTypes[i]);
+    JsonWriter writer(out, config.indent);
+
+    writer.beginArray();
+    for (auto type : types) {
+        dumpAsJsonObj(writer, type);
     }
+    writer.endArray();
+
+    out << "\n";
+}
+
+std::string JsonClassDumper::dump(Type *cls, DumpConfig config) {
+    std::stringstream ss;
+    JsonWriter writer(ss, config.jsonLines ? -1 : config.indent);
 
-    for (int i = 0; i < cls->fields.size(); i++) {
-        auto * field = cls->fields[i];
-        js["fields"][i]["name"] = field->name;
+    dumpAsJsonObj(writer, cls);
+    return ss.str();
+}
+
+void JsonClassDumper::dumpAsJsonObj(JsonWriter &writer, Type *cls) {
+    writer.beginObject();
 
-        setType(js["fields"][i]["type"], field->typePtr);
+    writer.key("className");
+    writer.value(cls->name);
+    writer.key("kind");
+    writer.value(typeKindNames[cls->kind]);
 
-        js["fields"][i]["accessibility"] = accesibilityNames[field->accessibility];
-        js["fields"][i]["isStatic"] = field->isStatic;
-        js["fields"][i]["offset"] = field->offset;
-        js["fields"][i]["address"] = field->address;
+    if (cls->underlyingType != nullptr) {
+        writer.key("underlyingType");
+        writer.beginObject();
+        writeType(writer, cls->underlyingType);
+        writer.endObject();
     }
 
-    for (int i = 0; i < cls->allMethods.size(); i++) {
-        auto * method = cls->allMethods[i];
-        js["methods"][i]["name"] = method->name;
+    if (!cls->enumerators.empty()) {
+        writer.key("enumerators");
+        writer.beginArray();
+        for (auto enumerator : cls->enumerators) {
+            writer.beginObject();
+            writer.key("name");
+            writer.value(enumerator->name);
+            writer.key("value");
+            writer.value(enumerator->value);
+            writer.endObject();
+        }
+        writer.endArray();
+    }
 
-        setType(js["methods"][i]["returnType"], method->returnType);
+    if (!cls->templateParameters.empty()) {
+        writer.key("templateParameters");
+        writer.beginArray();
+        for (auto parameter : cls->templateParameters) {
+            writer.beginObject();
+            writer.key("name");
+            writer.value(parameter->name);
+
+            if (parameter->typePtr != nullptr) {
+                writeType(writer, parameter->typePtr);
+            }
+
+            if (!parameter->value.empty()) {
+                writer.key("value");
+                writer.value(parameter->value);
+            }
+            writer.endObject();
+        }
+        writer.endArray();
+    }
 
-        js["methods"][i]["isStatic"] = method->isStatic;
-        js["methods"][i]["isVariadic"] = method->isVariadic;
-        js["methods"][i]["isVirtual"] = method->isVirtual;
-        js["methods"][i]["isCompilerGenerated"] = method->isCompilerGenerated;
+    if (!cls->baseTypes.empty()) {
+        writer.key("baseClass");
+        writer.value(cls->baseTypes[0]->name);
+    }
 
-        js["methods"][i]["accessibility"] = accesibilityNames[method->accessibility];
-        js["methods"][i]["address"] = method->address;
-        js["methods"][i]["vftableOffset"] = method->vftableOffset;
-        js["methods"][i]["callType"] = callingConventionNames[method->callType];
+    if (!cls->nestedTypes.empty()) {
+        writer.key("nestedTypes");
+        writer.beginArray();
+        for (auto nestedType : cls->nestedTypes) {
+            dumpAsJsonObj(writer, nestedType);
+        }
+        writer.endArray();
+    }
 
-        for (int j = 0; j < method->args.size(); j++) {
-            Argument *arg = method->args[j];
-            js["methods"][i]["args"][j]["name"] = arg->name;
+    if (!cls->fields.empty()) {
+        writer.key("fields");
+        writer.beginArray();
+        for (auto field : cls->fields) {
+            writer.beginObject();
+
+            writer.key("name");
+            writer.value(field->name);
+
+            writer.key("type");
+            writer.beginObject();
+            writeType(writer, field->typePtr);
+            writer.endObject();
+
+            writer.key("accessibility");
+            writer.value(accesibilityNames[field->accessibility]);
+            writer.key("isStatic");
+            writer.value(field->isStatic);
+            writer.key("offset");
+            writer.value(field->offset);
+            writer.key("address");
+            writer.value(field->address);
+
+            writer.endObject();
+        }
+        writer.endArray();
+    }
 
-            setType(js["methods"][i]["args"][j], arg->typePtr);
+    if (!cls->allMethods.empty()) {
+        writer.key("methods");
+        writer.beginArray();
+        for (auto method : cls->allMethods) {
+            writer.beginObject();
+
+            writer.key("name");
+            writer.value(method->name);
+
+            writer.key("returnType");
+            writer.beginObject();
+            writeType(writer, method->returnType);
+            writer.endObject();
+
+            writer.key("isStatic");
+            writer.value(method->isStatic);
+            writer.key("isVariadic");
+            writer.value(method->isVariadic);
+            writer.key("isVirtual");
+            writer.value(method->isVirtual);
+            writer.key("isCompilerGenerated");
+            writer.value(method->isCompilerGenerated);
+
+            writer.key("accessibility");
+            writer.value(accesibilityNames[method->accessibility]);
+            writer.key("address");
+            writer.value(method->address);
+            writer.key("vftableOffset");
+            writer.value(method->vftableOffset);
+            writer.key("callType");
+            writer.value(callingConventionNames[method->callType]);
+
+            if (!method->args.empty()) {
+                writer.key("args");
+                writer.beginArray();
+                for (auto arg : method->args) {
+                    writer.beginObject();
+
+                    writer.key("name");
+                    writer.value(arg->name);
+                    writeType(writer, arg->typePtr);
+
+                    writer.endObject();
+                }
+                writer.endArray();
+            }
+
+            writer.endObject();
         }
+        writer.endArray();
     }
 
-    return js;
+    writer.endObject();
 }
 
-void JsonClassDumper::setType(json &obj, TypePtr *typePtr) {
-    obj["type"] = typePtr->type;
-    obj["isPointer"] = typePtr->isPointer;
-    obj["isBaseType"] = typePtr->isBaseType;
-    obj["isConstant"] = typePtr->isConstant;
-    obj["isReference"] = typePtr->isReference;
-    obj["isArray"] = typePtr->isArray;
-    obj["arraySize"] = typePtr->arraySize;
+// Writes type description into currently open object
+void JsonClassDumper::writeType(JsonWriter &writer, TypePtr *typePtr) {
+    writer.key("type");
+    writer.value(typePtr->type);
+    writer.key("isPointer");
+    writer.value(typePtr->isPointer);
+    writer.key("isBaseType");
+    writer.value(typePtr->isBaseType);
+    writer.key("isConstant");
+    writer.value(typePtr->isConstant);
+    writer.key("isVolatile");
+    writer.value(typePtr->isVolatile);
+    writer.key("isReference");
+    writer.value(typePtr->isReference);
+    writer.key("isRvalueReference");
+    writer.value(typePtr->isRvalueReference);
+    writer.key("isArray");
+    writer.value(typePtr->isArray);
+    writer.key("arraySize");
+    writer.value(typePtr->arraySize);
 }
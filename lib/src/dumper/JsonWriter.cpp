@@ -0,0 +1,143 @@
+#include <cstdio>
+#include "dumper/JsonWriter.hpp"
+
+namespace debugtocpp {
+
+void JsonWriter::beginObject() {
+    begin('{');
+}
+
+void JsonWriter::endObject() {
+    end('}');
+}
+
+void JsonWriter::beginArray() {
+    begin('[');
+}
+
+void JsonWriter::endArray() {
+    end(']');
+}
+
+void JsonWriter::key(const std::string &name) {
+    beginValue();
+    writeString(name);
+    out << (indent >= 0 ? ": " : ":");
+    afterKey = true;
+}
+
+void JsonWriter::value(const std::string &value) {
+    beginValue();
+    writeString(value);
+}
+
+void JsonWriter::value(const char *value) {
+    beginValue();
+    writeString(value);
+}
+
+void JsonWriter::value(bool value) {
+    beginValue();
+    out << (value ? "true" : "false");
+}
+
+void JsonWriter::value(int value) {
+    beginValue();
+    out << std::dec << value;
+}
+
+void JsonWriter::value(long value) {
+    beginValue();
+    out << std::dec << value;
+}
+
+void JsonWriter::value(unsigned long value) {
+    beginValue();
+    out << std::dec << value;
+}
+
+// Emits separator and indentation before array element or object key
+void JsonWriter::beginValue() {
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+
+    if (scopes.empty()) {
+        return;
+    }
+
+    if (!scopes.back().empty) {
+        out << ',';
+    }
+
+    scopes.back().empty = false;
+    newLine(scopes.size());
+}
+
+void JsonWriter::begin(char bracket) {
+    beginValue();
+    out << bracket;
+    scopes.emplace_back();
+}
+
+void JsonWriter::end(char bracket) {
+    bool empty = scopes.back().empty;
+    scopes.pop_back();
+
+    if (!empty) {
+        newLine(scopes.size());
+    }
+
+    out << bracket;
+}
+
+void JsonWriter::newLine(size_t depth) {
+    if (indent < 0) {
+        return;
+    }
+
+    out << '\n' << std::string(depth * indent, ' ');
+}
+
+void JsonWriter::writeString(const std::string &str) {
+    out << '"';
+
+    for (char c : str) {
+        switch (c) {
+            case '"':
+                out << "\\\"";
+                break;
+            case '\\':
+                out << "\\\\";
+                break;
+            case '\b':
+                out << "\\b";
+                break;
+            case '\f':
+                out << "\\f";
+                break;
+            case '\n':
+                out << "\\n";
+                break;
+            case '\r':
+                out << "\\r";
+                break;
+            case '\t':
+                out << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[7];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out << escaped;
+                } else {
+                    out << c;
+                }
+        }
+    }
+
+    out << '"';
+}
+
+}
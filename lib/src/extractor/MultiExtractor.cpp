@@ -0,0 +1,142 @@
+#include <iterator>
+#include <set>
+#include "extractor/MultiExtractor.hpp"
+
+namespace debugtocpp {
+
+MultiExtractor::MultiExtractor(std::vector<Extractor *> extractors) : extractors(std::move(extractors)) {}
+
+// Inputs are loaded separately before they are combined, see getExtractorForFiles
+ExtractResult MultiExtractor::load(std::string filename, int image_base) {
+    throw std::string("MultiExtractor combines already loaded extractors, load them separately");
+}
+
+Type *MultiExtractor::getType(std::string name) {
+    std::list<std::string> typesList;
+    typesList.push_back(name);
+
+    std::vector<Type *> result = getTypes(typesList);
+    return !result.empty() ? result[0] : nullptr;
+}
+
+// Every type is extracted only once, from the first input that lists it
+std::vector<Type *> MultiExtractor::getTypes(std::list<std::string> typesList) {
+    buildIndex();
+
+    std::map<Extractor *, std::list<std::string>> requests;
+    std::list<std::string> unknown;
+    std::set<std::string> requested;
+
+    for (auto &name : typesList) {
+        if (!requested.insert(name).second) {
+            continue;
+        }
+
+        auto it = owners.find(name);
+        if (it != owners.end()) {
+            requests[it->second].push_back(name);
+        } else {
+            unknown.push_back(name);
+        }
+    }
+
+    // Results are keyed by the requested name, extractors may return types under their full name.
+    // Extractors returning one entry per requested name keep the order, the others are matched by type name
+    std::map<std::string, Type *> found;
+    for (auto &request : requests) {
+        std::list<std::string> &names = request.second;
+        std::vector<Type *> types = request.first->getTypes(names);
+
+        auto name = names.begin();
+        for (auto type : types) {
+            if (type != nullptr) {
+                found.emplace(types.size() == names.size() ? *name : type->name, type);
+            }
+
+            if (name != names.end()) {
+                ++name;
+            }
+        }
+    }
+
+    // Not every extractor can list its types, ask them one by one
+    for (auto &name : unknown) {
+        for (auto extractor : extractors) {
+            Type * type = extractor->getType(name);
+            if (type != nullptr) {
+                found.emplace(name, type);
+                break;
+            }
+        }
+    }
+
+    // Keep requested order, duplicated names are returned once
+    std::vector<Type *> types;
+    for (auto &name : typesList) {
+        auto it = found.find(name);
+        if (it != found.end() && it->second != nullptr) {
+            types.push_back(it->second);
+            it->second = nullptr;
+        }
+    }
+
+    return types;
+}
+
+std::list<std::string> MultiExtractor::getTypesList(bool showStructs) {
+    std::list<std::string> names;
+    std::set<std::string> seen;
+
+    for (auto extractor : extractors) {
+        for (auto &name : extractor->getTypesList(showStructs)) {
+            if (seen.insert(name).second) {
+                names.push_back(name);
+            }
+        }
+    }
+
+    return names;
+}
+
+std::vector<Field *> MultiExtractor::getAllGlobalVariables() {
+    std::vector<Field *> variables;
+    std::set<std::string> seen;
+
+    for (auto extractor : extractors) {
+        for (auto variable : extractor->getAllGlobalVariables()) {
+            if (seen.insert(variable->name).second) {
+                variables.push_back(variable);
+            }
+        }
+    }
+
+    return variables;
+}
+
+// Identical ranges from several inputs are kept once by the index, from the first input
+std::vector<AddressRange> MultiExtractor::getAddressRanges() {
+    std::vector<AddressRange> ranges;
+
+    for (auto extractor : extractors) {
+        std::vector<AddressRange> extracted = extractor->getAddressRanges();
+        ranges.insert(ranges.end(), std::make_move_iterator(extracted.begin()), std::make_move_iterator(extracted.end()));
+    }
+
+    return ranges;
+}
+
+void MultiExtractor::buildIndex() {
+    if (indexed) {
+        return;
+    }
+
+    for (auto extractor : extractors) {
+        for (auto &name : extractor->getTypesList(true)) {
+            owners.emplace(name, extractor);
+        }
+    }
+
+    indexed = true;
+}
+
+}
@@ -1,10 +1,71 @@
 #include <fcntl.h>
 #include "extractor/dwarf/DWARFExtractor.hpp"
+#include "extractor/dwarf/SplitDwarf.hpp"
 #include <iostream>
 
 namespace debugtocpp {
 namespace dwarf {
 
+namespace {
+
+// die.attributes() decodes every attribute of the DIE, this only decodes the requested one
+std::string stringAttribute(const ::dwarf::die &die, ::dwarf::DW_AT attribute) {
+    return die.has(attribute) ? die[attribute].as_string() : std::string();
+}
+
+// Constants without explicit signedness (DW_FORM_data*) are read as signed
+bool constantAttribute(const ::dwarf::die &die, ::dwarf::DW_AT attribute, long &out) {
+    if (!die.has(attribute)) {
+        return false;
+    }
+
+    ::dwarf::value value = die[attribute];
+    switch (value.get_type()) {
+        case ::dwarf::value::type::uconstant:
+            out = static_cast<long>(value.as_uconstant());
+            return true;
+        case ::dwarf::value::type::constant:
+        case ::dwarf::value::type::sconstant:
+            out = static_cast<long>(value.as_sconstant());
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool isRecord(::dwarf::DW_TAG tag) {
+    return tag == ::dwarf::DW_TAG::class_type || tag == ::dwarf::DW_TAG::structure_type ||
+           tag == ::dwarf::DW_TAG::union_type;
+}
+
+bool isModifier(::dwarf::DW_TAG tag) {
+    return tag == ::dwarf::DW_TAG::pointer_type || tag == ::dwarf::DW_TAG::reference_type ||
+           tag == ::dwarf::DW_TAG::rvalue_reference_type || tag == ::dwarf::DW_TAG::const_type ||
+           tag == ::dwarf::DW_TAG::volatile_type || tag == ::dwarf::DW_TAG::array_type;
+}
+
+// Follows typedefs and cv-qualifiers to the type they describe
+::dwarf::die stripType(::dwarf::die die) {
+    for (int depth = 0; depth < 16; depth++) {
+        if ((die.tag != ::dwarf::DW_TAG::typedef_ && die.tag != ::dwarf::DW_TAG::const_type &&
+             die.tag != ::dwarf::DW_TAG::volatile_type) || !die.has(::dwarf::DW_AT::type)) {
+            break;
+        }
+
+        die = die[::dwarf::DW_AT::type].as_reference();
+    }
+
+    return die;
+}
+
+std::string describe(const TypePtr &typePtr) {
+    return std::string(typePtr.isConstant ? "const " : "") + (typePtr.isVolatile ? "volatile " : "") + typePtr.type +
+           (typePtr.isReference ? "&" : "") + (typePtr.isRvalueReference ? "&&" : "") +
+           (typePtr.isPointer ? " *" : "");
+}
+
+}
+
 ExtractResult debugtocpp::dwarf::DWARFExtractor::load(std::string filename, int image_base) {
     int fd = open(filename.c_str(), O_RDONLY);
 
@@ -12,9 +73,18 @@ ExtractResult debugtocpp::dwarf::DWARFExtractor::load(std::string filename, int
         return ExtractResult::ERR_FILE_OPEN;
     }
 
+    this->filename = filename;
+
     try {
         elf = new ::elf::elf(::elf::create_mmap_loader(fd));
-        dwarf = new ::dwarf::dwarf(::dwarf::elf::create_loader(*elf));
+        sections = std::make_shared<DebugSections>(*elf);
+
+        // Addresses of position independent binaries are relative to the load address
+        imageBase = elf->get_hdr().type == ::elf::et::dyn ? static_cast<uint64_t>(image_base) : 0;
+
+        // Unit headers are parsed here, other sections are decompressed when they are first read
+        sections->prefetch({::dwarf::section_type::info, ::dwarf::section_type::abbrev});
+        dwarf = new ::dwarf::dwarf(sections);
     } catch (::elf::format_error &e) {
         if (strcmp(e.what(), "bad ELF magic number") == 0) {
             return ExtractResult::INVALID_FILE;
@@ -25,236 +95,905 @@ ExtractResult debugtocpp::dwarf::DWARFExtractor::load(std::string filename, int
         if (strcmp(e.what(), "required .debug_info section missing") == 0) {
             return ExtractResult::MISSING_DEBUG;
         }
+
+        return ExtractResult::UNSUPPORTED_VERSION;
     }
 
     return ExtractResult::OK;
 }
 
 Type *debugtocpp::dwarf::DWARFExtractor::getType(std::string name) {
-    for (auto &cu : dwarf->compilation_units()) {
-        ::dwarf::die result = findTypeNode(cu.root(), name);
+    const TypeDefinition * definition = findDefinition(name);
 
-        if (result.valid()) {
-            return getType(result, name);
-        }
+    if (definition == nullptr) {
+        return nullptr;
     }
 
-    return nullptr;
+    // Method lookups can index split units, which moves entries of the index
+    TypeDefinition found = *definition;
+    return getType(found, name);
 }
 
-Type *DWARFExtractor::getType(const ::dwarf::die &node, std::string &name) {
+Type *DWARFExtractor::getType(const TypeDefinition &definition, std::string &name) {
+    const ::dwarf::die &node = definition.node;
     Type * type = new Type(name);
     std::vector<Method *> methods;
 
+    switch (node.tag) {
+        case ::dwarf::DW_TAG::enumeration_type:
+            type->kind = TypeKind::ENUM;
+            getEnumerators(node, type);
+            return type;
+        case ::dwarf::DW_TAG::typedef_:
+            type->kind = TypeKind::TYPEDEF;
+            type->underlyingType = node.has(::dwarf::DW_AT::type) ?
+                                   getTypePtr(node[::dwarf::DW_AT::type].as_reference()) : new TypePtr("void", false);
+            return type;
+        case ::dwarf::DW_TAG::structure_type:
+            type->kind = TypeKind::STRUCT;
+            break;
+        case ::dwarf::DW_TAG::union_type:
+            type->kind = TypeKind::UNION;
+            break;
+        default:
+            break;
+    }
+
     for (const ::dwarf::die &child : node) {
 
-        if (child.tag == ::dwarf::DW_TAG::inheritance) {
-            for (auto &attr : child.attributes()) {
-                if (attr.first == ::dwarf::DW_AT::type) {
-                    Type * baseType = new Type();
+        if (child.tag == ::dwarf::DW_TAG::template_type_parameter ||
+            child.tag == ::dwarf::DW_TAG::template_value_parameter) {
+            auto * parameter = new TemplateParameter();
+            parameter->name = stringAttribute(child, ::dwarf::DW_AT::name);
 
-                    for (auto &subAttr : attr.second.as_reference().attributes()) {
-                        if (subAttr.first == ::dwarf::DW_AT::name) {
-                            baseType->name = subAttr.second.as_string();
-                        }
-                    }
+            if (child.has(::dwarf::DW_AT::type)) {
+                parameter->typePtr = getTypePtr(child[::dwarf::DW_AT::type].as_reference());
+            }
 
-                    type->baseTypes.push_back(baseType);
-                }
+            long value;
+            if (constantAttribute(child, ::dwarf::DW_AT::const_value, value)) {
+                parameter->value = std::to_string(value);
             }
+
+            type->templateParameters.push_back(parameter);
         }
 
-        if (child.tag == ::dwarf::DW_TAG::member) {
+        if (child.tag == ::dwarf::DW_TAG::inheritance && child.has(::dwarf::DW_AT::type)) {
+            Type * baseType = new Type();
+            baseType->name = stringAttribute(child[::dwarf::DW_AT::type].as_reference(), ::dwarf::DW_AT::name);
+
+            type->baseTypes.push_back(baseType);
+        }
+
+        // DWARF 5 describes static members as variables
+        if (child.tag == ::dwarf::DW_TAG::member || child.tag == ::dwarf::DW_TAG::variable) {
             auto * field = new Field();
+            field->name = stringAttribute(child, ::dwarf::DW_AT::name);
+            field->isStatic = child.tag == ::dwarf::DW_TAG::variable;
 
-            for (auto &attr : child.attributes()) {
-                if (attr.first == ::dwarf::DW_AT::name) {
-                    field->name = attr.second.as_string();
-                }
+            if (child.has(::dwarf::DW_AT::type)) {
+                field->typePtr = getTypePtr(child[::dwarf::DW_AT::type].as_reference());
+            }
 
-                if (attr.first == ::dwarf::DW_AT::type) {
-                    field->typePtr = getTypePtr(attr.second.as_reference());
-                }
+            if (child.has(::dwarf::DW_AT::external)) {
+                field->isStatic = child[::dwarf::DW_AT::external].as_flag();
+            }
 
-                if (attr.first == ::dwarf::DW_AT::external) {
-                    field->isStatic = attr.second.as_flag();
-                }
+            auto address = staticMemberAddresses.find({&child.get_unit(), child.get_section_offset()});
+            if (field->isStatic && address != staticMemberAddresses.end()) {
+                field->address = address->second;
+            }
 
-                if (attr.first == ::dwarf::DW_AT::accessibility) {
-                    field->accessibility = static_cast<Accessibility>(attr.second.as_uconstant());
-                }
+            if (child.has(::dwarf::DW_AT::accessibility)) {
+                field->accessibility = static_cast<Accessibility>(child[::dwarf::DW_AT::accessibility].as_uconstant());
+            }
+
+            long offset;
+            if (constantAttribute(child, ::dwarf::DW_AT::data_member_location, offset)) {
+                field->offset = static_cast<int>(offset);
             }
+
             type->fields.push_back(field);
         }
 
         if (child.tag == ::dwarf::DW_TAG::subprogram) {
-            auto * method = new Method();
-            method->returnType = new TypePtr("void", false);
+            methods.push_back(getMethod(child, node));
+        }
+    }
 
-            for (auto &attr : child.attributes()) {
-                if (attr.first == ::dwarf::DW_AT::name) {
-                    method->name = attr.second.as_string();
-                }
+    // Units declare different implicit special members and member template instantiations of the same type
+    auto methodKey = [](const ::dwarf::die &child) {
+        std::string linkageName = stringAttribute(child, ::dwarf::DW_AT::linkage_name);
+        return linkageName.empty() ? stringAttribute(child, ::dwarf::DW_AT::name) : linkageName;
+    };
 
-                if (attr.first == ::dwarf::DW_AT::type) {
-                    delete(method->returnType);
-                    method->returnType = getTypePtr(attr.second.as_reference());
-                }
+    std::set<std::string> declared;
+    for (const ::dwarf::die &child : node) {
+        if (child.tag == ::dwarf::DW_TAG::subprogram) {
+            declared.insert(methodKey(child));
+        }
+    }
 
-                if (attr.first == ::dwarf::DW_AT::linkage_name) {
-                    method->mangledName = attr.second.as_string();
-                }
+    for (auto &variant : definition.methodVariants) {
+        for (const ::dwarf::die &child : variant.second) {
+            if (child.tag == ::dwarf::DW_TAG::subprogram && declared.insert(methodKey(child)).second) {
+                methods.push_back(getMethod(child, node));
+            }
+        }
+    }
+
+    updateMethods(methods);
+    type->allMethods = methods;
+    type->fullyDefinedMethods = methods;
+
+    return type;
+}
+
+Method *DWARFExtractor::getMethod(const ::dwarf::die &child, const ::dwarf::die &type) {
+    auto * method = new Method();
+    method->name = stringAttribute(child, ::dwarf::DW_AT::name);
+    method->mangledName = stringAttribute(child, ::dwarf::DW_AT::linkage_name);
+
+    if (child.has(::dwarf::DW_AT::type)) {
+        method->returnType = getTypePtr(child[::dwarf::DW_AT::type].as_reference());
+    } else {
+        method->returnType = new TypePtr("void", false);
+    }
+
+    if (child.has(::dwarf::DW_AT::accessibility)) {
+        method->accessibility = static_cast<Accessibility>(child[::dwarf::DW_AT::accessibility].as_uconstant());
+    }
+
+    if (child.has(::dwarf::DW_AT::artificial)) {
+        method->isCompilerGenerated = child[::dwarf::DW_AT::artificial].as_flag();
+    }
+
+    if (child.has(::dwarf::DW_AT::virtuality)) {
+        method->isVirtual = child[::dwarf::DW_AT::virtuality].as_uconstant() != 0;
+    }
+
+    // Constructors are named like the type without its scope and template arguments
+    std::string typeName = stringAttribute(type, ::dwarf::DW_AT::name);
+    if (method->name == typeName.substr(0, typeName.find('<'))) {
+        method->returnType->type = "";
+    }
+
+    return method;
+}
+
+void DWARFExtractor::getEnumerators(const ::dwarf::die &node, Type *type) {
+    if (node.has(::dwarf::DW_AT::type)) {
+        type->underlyingType = getTypePtr(node[::dwarf::DW_AT::type].as_reference());
+    }
+
+    for (const ::dwarf::die &child : node) {
+        long value = 0;
+
+        if (child.tag == ::dwarf::DW_TAG::enumerator) {
+            constantAttribute(child, ::dwarf::DW_AT::const_value, value);
+            type->enumerators.push_back(new Enumerator(stringAttribute(child, ::dwarf::DW_AT::name), value));
+        }
+    }
+}
 
-                if (attr.first == ::dwarf::DW_AT::accessibility) {
-                    method->accessibility = static_cast<Accessibility>(attr.second.as_uconstant());
+// Callers modify returned descriptions, so every caller gets its own copy
+TypePtr * DWARFExtractor::getTypePtr(const ::dwarf::die &die) {
+    return new TypePtr(getCachedTypePtr(die));
+}
+
+// Same types are referenced by many members and arguments, every type DIE is resolved only once
+const TypePtr &DWARFExtractor::getCachedTypePtr(const ::dwarf::die &die) {
+    auto key = std::make_pair(&die.get_unit(), die.get_section_offset());
+
+    auto it = typePtrCache.find(key);
+    if (it == typePtrCache.end()) {
+        it = typePtrCache.emplace(key, resolveTypePtr(die)).first;
+    }
+
+    return it->second;
+}
+
+TypePtr DWARFExtractor::resolveTypePtr(const ::dwarf::die &die) {
+    if (die.tag == ::dwarf::DW_TAG::subroutine_type) {
+        TypePtr function(getFunctionSignature(die, ""), false);
+        function.isBaseType = true;
+
+        return function;
+    }
+
+    if (isModifier(die.tag)) {
+        // void *, const void...
+        if (!die.has(::dwarf::DW_AT::type)) {
+            TypePtr voidType("void", die.tag == ::dwarf::DW_TAG::pointer_type);
+            voidType.isBaseType = true;
+            voidType.isConstant = die.tag == ::dwarf::DW_TAG::const_type;
+            voidType.isVolatile = die.tag == ::dwarf::DW_TAG::volatile_type;
+
+            return voidType;
+        }
+
+        ::dwarf::die target = die[::dwarf::DW_AT::type].as_reference();
+
+        // Function pointers are described by the whole signature
+        if (die.tag == ::dwarf::DW_TAG::pointer_type && stripType(target).tag == ::dwarf::DW_TAG::subroutine_type) {
+            TypePtr function(getFunctionSignature(stripType(target), "(*)"), false);
+            function.isBaseType = true;
+
+            return function;
+        }
+
+        // Modifiers of the pointed type are only added, so that const of pointed type isn't lost
+        TypePtr type = getCachedTypePtr(target);
+
+        // TypePtr holds one level of pointer, modifiers of a pointer itself are kept in the name,
+        // e.g. "int * const" or "char * *"
+        if (stripType(target).tag == ::dwarf::DW_TAG::pointer_type && die.tag != ::dwarf::DW_TAG::array_type) {
+            std::string pointer = describe(type);
+            type = TypePtr(pointer, false);
+            type.isBaseType = true;
+
+            if (die.tag == ::dwarf::DW_TAG::const_type || die.tag == ::dwarf::DW_TAG::volatile_type) {
+                type.type += die.tag == ::dwarf::DW_TAG::const_type ? " const" : " volatile";
+                return type;
+            }
+        }
+
+        switch (die.tag) {
+            case ::dwarf::DW_TAG::pointer_type:
+                type.isPointer = true;
+                break;
+            case ::dwarf::DW_TAG::reference_type:
+                type.isReference = true;
+                type.isPointer = false;
+                break;
+            case ::dwarf::DW_TAG::rvalue_reference_type:
+                type.isRvalueReference = true;
+                type.isPointer = false;
+                break;
+            case ::dwarf::DW_TAG::const_type:
+                type.isConstant = true;
+                break;
+            case ::dwarf::DW_TAG::volatile_type:
+                type.isVolatile = true;
+                break;
+            default:
+                type.isArray = true;
+
+                for (const ::dwarf::die &arrayChild : die) {
+                    long size;
+                    if (arrayChild.tag != ::dwarf::DW_TAG::subrange_type) {
+                        continue;
+                    }
+
+                    if (constantAttribute(arrayChild, ::dwarf::DW_AT::count, size)) {
+                        type.arraySize = static_cast<int>(size);
+                    } else if (constantAttribute(arrayChild, ::dwarf::DW_AT::upper_bound, size)) {
+                        type.arraySize = static_cast<int>(size + 1);
+                    }
                 }
+        }
 
-                if (attr.first == ::dwarf::DW_AT::artificial) {
-                    method->isCompilerGenerated = attr.second.as_flag();
+        return type;
+    }
+
+    TypePtr typePtr(die.has(::dwarf::DW_AT::name) ? die[::dwarf::DW_AT::name].as_string() : "unknown", true);
+
+    if (die.tag == ::dwarf::DW_TAG::base_type || die.tag == ::dwarf::DW_TAG::unspecified_type ||
+        die.tag == ::dwarf::DW_TAG::enumeration_type) {
+        typePtr.isPointer = false;
+        typePtr.isBaseType = true;
+    } else if (die.tag == ::dwarf::DW_TAG::typedef_) {
+        // Aliases are shown like the type they stand for, records as pointers and everything else as it is
+        ::dwarf::die target = stripType(die);
+        typePtr.isPointer = isRecord(target.tag);
+        typePtr.isBaseType = !typePtr.isPointer;
+    }
+
+    return typePtr;
+}
+
+// e.g. "void (*)(int, char *)" for pointer to function
+std::string DWARFExtractor::getFunctionSignature(const ::dwarf::die &die, const std::string &declarator) {
+    std::string signature = die.has(::dwarf::DW_AT::type) ?
+                            describe(getCachedTypePtr(die[::dwarf::DW_AT::type].as_reference())) : "void";
+    signature += " " + declarator + "(";
+
+    bool first = true;
+    for (const ::dwarf::die &child : die) {
+        if (child.tag != ::dwarf::DW_TAG::formal_parameter && child.tag != ::dwarf::DW_TAG::unspecified_parameters) {
+            continue;
+        }
+
+        signature += first ? "" : ", ";
+        first = false;
+
+        if (child.tag == ::dwarf::DW_TAG::unspecified_parameters) {
+            signature += "...";
+        } else if (child.has(::dwarf::DW_AT::type)) {
+            signature += describe(getCachedTypePtr(child[::dwarf::DW_AT::type].as_reference()));
+        }
+    }
+
+    return signature + ")";
+}
+
+// Arguments are only present in out of line definitions, which refer to the declaration by DW_AT_specification
+void DWARFExtractor::updateMethods(std::vector<Method *> &methods) {
+    for (auto method : methods) {
+        auto it = methodDefinitions.find(method->mangledName);
+        if (!method->mangledName.empty() && it == methodDefinitions.end() && indexSplitUnits()) {
+            it = methodDefinitions.find(method->mangledName);
+        }
+
+        if (method->mangledName.empty() || it == methodDefinitions.end()) {
+            continue;
+        }
+
+        for (const ::dwarf::die &subChild : it->second) {
+            if (subChild.tag == ::dwarf::DW_TAG::formal_parameter) {
+                auto *arg = new Argument();
+                arg->name = stringAttribute(subChild, ::dwarf::DW_AT::name);
+
+                if (subChild.has(::dwarf::DW_AT::type)) {
+                    arg->typePtr = getTypePtr(subChild[::dwarf::DW_AT::type].as_reference());
                 }
+
+                method->args.push_back(arg);
             }
+        }
+    }
+}
+
+std::list<std::string> debugtocpp::dwarf::DWARFExtractor::getTypesList(bool showStructs) {
+    buildIndex();
+    indexSplitUnits();
+
+    std::list<std::string> names;
+    for (auto &entry : typeIndex) {
+        if (showStructs || entry.second.front().node.tag != ::dwarf::DW_TAG::structure_type) {
+            names.push_back(entry.first);
+        }
+    }
+
+    return names;
+}
+
+std::vector<Type *> DWARFExtractor::getTypes(std::list<std::string> typesList) {
+    std::vector<Type *> types;
+    for (std::string &name : typesList) {
+        types.push_back(getType(name));
+    }
+
+    return types;
+}
+
+std::vector<Field *> DWARFExtractor::getAllGlobalVariables() {
+    buildIndex();
+    indexSplitUnits();
+
+    std::vector<Field *> fields;
+    fields.reserve(globalVariables.size());
+
+    for (auto &variable : globalVariables) {
+        const ::dwarf::die &declaration = variable.declaration;
+
+        auto * field = new Field();
+        field->address = variable.address;
+        field->accessibility = Accessibility::PUBLIC;
+
+        field->name = getVariableName(variable);
+
+        if (variable.node.has(::dwarf::DW_AT::type)) {
+            field->typePtr = getTypePtr(variable.node[::dwarf::DW_AT::type].as_reference());
+        } else if (declaration.has(::dwarf::DW_AT::type)) {
+            field->typePtr = getTypePtr(declaration[::dwarf::DW_AT::type].as_reference());
+        } else {
+            field->typePtr = new TypePtr("void", false);
+        }
+
+        fields.push_back(field);
+    }
+
+    return fields;
+}
+
+std::string DWARFExtractor::getVariableName(const GlobalVariable &variable) {
+    const ::dwarf::die &declaration = variable.declaration;
+
+    auto member = staticMemberNames.find({&declaration.get_unit(), declaration.get_section_offset()});
+    if (member != staticMemberNames.end()) {
+        return member->second;
+    }
 
-            if (method->name == type->name) {
-                method->returnType->type = "";
+    return variable.scope + stringAttribute(declaration, ::dwarf::DW_AT::name);
+}
+
+// Functions cover their DW_AT_low_pc/high_pc or DW_AT_ranges, global variables the size of their type
+std::vector<AddressRange> DWARFExtractor::getAddressRanges() {
+    buildIndex();
+    indexSplitUnits();
+
+    std::vector<AddressRange> ranges;
+
+    for (auto &function : functionDefinitions) {
+        std::string name = getFunctionName(function);
+
+        try {
+            for (auto &entry : ::dwarf::die_pc_range(function.node)) {
+                AddressRange range;
+                range.start = entry.low + imageBase;
+                range.size = entry.high - entry.low;
+                range.name = name;
+                range.isFunction = true;
+
+                ranges.push_back(range);
             }
+        } catch (::dwarf::format_error &e) {
+            // DWARF 5 range lists are not supported by libelfin
+        }
+    }
+
+    for (auto &variable : globalVariables) {
+        AddressRange range;
+        range.start = variable.address;
+        range.name = getVariableName(variable);
 
-            methods.push_back(method);
+        const ::dwarf::die &typed = variable.node.has(::dwarf::DW_AT::type) ? variable.node : variable.declaration;
+        if (typed.has(::dwarf::DW_AT::type)) {
+            range.size = getTypeSize(typed[::dwarf::DW_AT::type].as_reference());
         }
+
+        ranges.push_back(range);
     }
 
-    updateMethods(methods, node.get_unit(), node.get_section_offset());
-    type->allMethods = methods;
-    type->fullyDefinedMethods = methods;
+    return ranges;
+}
 
-    return type;
+// Out of line definitions get the name of their declaration in the class
+std::string DWARFExtractor::getFunctionName(const FunctionDefinition &function) {
+    ::dwarf::die declaration = function.node;
+
+    // Out of line copies of inlined functions refer to the abstract instance, which can refer to the declaration
+    if (declaration.has(::dwarf::DW_AT::abstract_origin)) {
+        declaration = declaration[::dwarf::DW_AT::abstract_origin].as_reference();
+    }
+    if (declaration.has(::dwarf::DW_AT::specification)) {
+        declaration = declaration[::dwarf::DW_AT::specification].as_reference();
+    }
+
+    auto it = methodNames.find({&declaration.get_unit(), declaration.get_section_offset()});
+    if (it != methodNames.end()) {
+        return it->second;
+    }
+
+    return function.scope + stringAttribute(declaration, ::dwarf::DW_AT::name);
 }
 
-TypePtr * DWARFExtractor::getTypePtr(const ::dwarf::die &die) {
-    TypePtr * typePtr = new TypePtr("unknown", true);
-
-    if (die.tag == ::dwarf::DW_TAG::pointer_type || die.tag == ::dwarf::DW_TAG::const_type ||
-        die.tag == ::dwarf::DW_TAG::reference_type || die.tag == ::dwarf::DW_TAG::array_type) {
-
-        for (auto &attr : die.attributes()) {
-            if (attr.first == ::dwarf::DW_AT::type) {
-                TypePtr * type = getTypePtr(attr.second.as_reference());
-
-                type->isPointer = die.tag == ::dwarf::DW_TAG::pointer_type;
-                type->isConstant = die.tag == ::dwarf::DW_TAG::const_type;
-                type->isReference = die.tag == ::dwarf::DW_TAG::reference_type;
-                type->isArray = die.tag == ::dwarf::DW_TAG::array_type;
-
-                if (type->isArray) {
-                    for (const ::dwarf::die &arrayChild : die) {
-                        if (arrayChild.tag == ::dwarf::DW_TAG::subrange_type) {
-                            for (auto &arrayAttr : arrayChild.attributes()) {
-                                if (arrayAttr.first == ::dwarf::DW_AT::upper_bound) {
-                                    type->arraySize = arrayAttr.second.as_sconstant() + 1;
-                                }
-                            }
-                        }
-                    }
+// Follows typedefs and qualifiers, declarations are replaced by their definition
+uint64_t DWARFExtractor::getTypeSize(const ::dwarf::die &type) {
+    long byteSize;
+    if (constantAttribute(type, ::dwarf::DW_AT::byte_size, byteSize)) {
+        return static_cast<uint64_t>(byteSize);
+    }
+
+    switch (type.tag) {
+        case ::dwarf::DW_TAG::pointer_type:
+        case ::dwarf::DW_TAG::reference_type:
+        case ::dwarf::DW_TAG::rvalue_reference_type:
+            return elf->get_hdr().ei_class == ::elf::elfclass::_64 ? 8 : 4;
+        case ::dwarf::DW_TAG::typedef_:
+        case ::dwarf::DW_TAG::const_type:
+        case ::dwarf::DW_TAG::volatile_type:
+            return type.has(::dwarf::DW_AT::type) ? getTypeSize(type[::dwarf::DW_AT::type].as_reference()) : 0;
+        case ::dwarf::DW_TAG::array_type: {
+            if (!type.has(::dwarf::DW_AT::type)) {
+                return 0;
+            }
+
+            uint64_t size = getTypeSize(type[::dwarf::DW_AT::type].as_reference());
+            for (const ::dwarf::die &child : type) {
+                if (child.tag != ::dwarf::DW_TAG::subrange_type) {
+                    continue;
                 }
 
-                return type;
+                // Bounds of variable length arrays are expressions, they have no constant size
+                long bound;
+                if (constantAttribute(child, ::dwarf::DW_AT::count, bound)) {
+                    size *= bound;
+                } else if (constantAttribute(child, ::dwarf::DW_AT::upper_bound, bound)) {
+                    size *= bound + 1;
+                } else {
+                    return 0;
+                }
             }
+
+            return size;
         }
+        default:
+            break;
     }
 
-    if (die.tag == ::dwarf::DW_TAG::base_type || die.tag == ::dwarf::DW_TAG::class_type) {
-        typePtr->isPointer = die.tag == ::dwarf::DW_TAG::class_type;
-        typePtr->isBaseType = die.tag == ::dwarf::DW_TAG::base_type;
-        for (auto &attr : die.attributes()) {
-            if (attr.first == ::dwarf::DW_AT::name) {
-                typePtr->type = attr.second.as_string();
-            }
+    if (type.has(::dwarf::DW_AT::declaration) && type.has(::dwarf::DW_AT::name)) {
+        const TypeDefinition *definition = findDefinition(type[::dwarf::DW_AT::name].as_string());
+        if (definition != nullptr && constantAttribute(definition->node, ::dwarf::DW_AT::byte_size, byteSize)) {
+            return static_cast<uint64_t>(byteSize);
         }
     }
 
-    return typePtr;
+    return 0;
 }
 
-::dwarf::die debugtocpp::dwarf::DWARFExtractor::findTypeNode(const ::dwarf::die &node, std::string &name) {
-    if (node.tag == ::dwarf::DW_TAG::class_type) {
-        for (auto &attr : node.attributes()) {
-            if (attr.first == ::dwarf::DW_AT::name && attr.second.as_string() == name) {
-                return node;
+namespace {
+
+const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+uint64_t hashValue(uint64_t hash, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        hash ^= (value >> (i * 8)) & 0xff;
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+uint64_t hashString(uint64_t hash, const std::string &str) {
+    for (char c : str) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= FNV_PRIME;
+    }
+
+    return hashValue(hash, str.size());
+}
+
+// Referenced types are identified by their name, unnamed modifiers (pointers, const...) are followed
+uint64_t hashTypeReference(uint64_t hash, const ::dwarf::die &die, int depth) {
+    hash = hashValue(hash, static_cast<uint64_t>(die.tag));
+
+    if (die.has(::dwarf::DW_AT::name)) {
+        return hashString(hash, die[::dwarf::DW_AT::name].as_string());
+    }
+
+    if (die.tag == ::dwarf::DW_TAG::array_type) {
+        for (const ::dwarf::die &child : die) {
+            if (child.tag == ::dwarf::DW_TAG::subrange_type && child.has(::dwarf::DW_AT::upper_bound)) {
+                hash = hashValue(hash, child[::dwarf::DW_AT::upper_bound].as_uconstant());
             }
         }
     }
 
-    for (auto &child : node) {
-        auto found = findTypeNode(child, name);
-        if (found.valid()) {
-            return found;
+    if (die.has(::dwarf::DW_AT::type) && depth < 16) {
+        return hashTypeReference(hash, die[::dwarf::DW_AT::type].as_reference(), depth + 1);
+    }
+
+    return hash;
+}
+
+uint64_t hashMember(uint64_t hash, const ::dwarf::die &die) {
+    hash = hashValue(hash, static_cast<uint64_t>(die.tag));
+
+    if (die.has(::dwarf::DW_AT::name)) {
+        hash = hashString(hash, die[::dwarf::DW_AT::name].as_string());
+    }
+
+    if (die.has(::dwarf::DW_AT::linkage_name)) {
+        hash = hashString(hash, die[::dwarf::DW_AT::linkage_name].as_string());
+    }
+
+    if (die.has(::dwarf::DW_AT::type)) {
+        hash = hashTypeReference(hash, die[::dwarf::DW_AT::type].as_reference(), 0);
+    }
+
+    long value;
+    if (constantAttribute(die, ::dwarf::DW_AT::data_member_location, value)) {
+        hash = hashValue(hash, static_cast<uint64_t>(value));
+    }
+
+    if (constantAttribute(die, ::dwarf::DW_AT::const_value, value)) {
+        hash = hashValue(hash, static_cast<uint64_t>(value));
+    }
+
+    return hash;
+}
+
+// Layout of the type: size, bases, data members and enumerators with their names, type names and offsets.
+// Methods are left out, units differ in implicitly declared special members and instantiated member templates
+uint64_t structuralHash(const ::dwarf::die &node) {
+    uint64_t hash = hashValue(FNV_OFFSET, static_cast<uint64_t>(node.tag));
+
+    if (node.has(::dwarf::DW_AT::byte_size)) {
+        hash = hashValue(hash, node[::dwarf::DW_AT::byte_size].as_uconstant());
+    }
+
+    for (const ::dwarf::die &child : node) {
+        if (child.tag == ::dwarf::DW_TAG::inheritance || child.tag == ::dwarf::DW_TAG::member ||
+            child.tag == ::dwarf::DW_TAG::variable || child.tag == ::dwarf::DW_TAG::enumerator) {
+            hash = hashMember(hash, child);
+        }
+    }
+
+    return hash;
+}
+
+// Method declarations of one copy of a type
+uint64_t methodsHash(const ::dwarf::die &node) {
+    uint64_t hash = FNV_OFFSET;
+
+    for (const ::dwarf::die &child : node) {
+        if (child.tag == ::dwarf::DW_TAG::subprogram) {
+            hash = hashMember(hash, child);
         }
     }
 
-    return ::dwarf::die();
+    return hash;
 }
 
-void DWARFExtractor::updateMethods(std::vector<Method *> &methods, const ::dwarf::unit &unit, ::dwarf::section_offset offset) {
+}
+
+// Single pass over all units, replaces searching every unit for each requested type
+void DWARFExtractor::buildIndex() {
+    if (indexed) {
+        return;
+    }
+
+    // Names are read from .debug_str while indexing, definitions can be in .debug_types
+    sections->prefetch({::dwarf::section_type::str, ::dwarf::section_type::types});
+
+    // -gsplit-dwarf leaves only skeleton units in the binary, their content is in split units loaded on demand
+    try {
+        skeletons = findSkeletonUnits(*sections);
+    } catch (std::exception &e) {
+        std::cerr << "Warning: failed to read split DWARF: " << e.what() << std::endl;
+    }
+
+    std::set<uint64_t> skeletonOffsets;
+    for (auto &skeleton : skeletons) {
+        skeletonOffsets.insert(skeleton.unitOffset);
+    }
+
     for (auto &cu : dwarf->compilation_units()) {
-        for (const ::dwarf::die &child : cu.root()) {
-            if (child.tag == ::dwarf::DW_TAG::subprogram) {
-                if (child.attributes()[0].first != ::dwarf::DW_AT::specification) {
-                    continue;
-                }
+        indexUnit(cu, skeletonOffsets.count(cu.get_section_offset()) > 0);
+    }
 
-                Method *method = nullptr;
+    // -fdebug-types-section moves definitions to .debug_types, units only keep declarations with DW_AT_signature.
+    // References using DW_FORM_ref_sig8 are resolved to these units by libelfin
+    try {
+        for (uint64_t signature : findTypeUnitSignatures(*sections)) {
+            indexUnit(dwarf->get_type_unit(signature));
+        }
+    } catch (std::exception &e) {
+        std::cerr << "Warning: failed to read DWARF type units: " << e.what() << std::endl;
+    }
 
-                for (auto &refAttrs : child.attributes()[0].second.as_reference().attributes()) {
-                    if (refAttrs.first == ::dwarf::DW_AT::linkage_name) {
-                        for (auto &m : methods) {
-                            if (m->mangledName == refAttrs.second.as_string()) {
-                                method = m;
-                            }
-                        }
-                    }
-                }
+    indexed = true;
+}
 
-                if (method == nullptr) {
-                    continue;
-                }
+// Split units are converted and indexed the first time a lookup is not answered by the binary's own units
+bool DWARFExtractor::indexSplitUnits() {
+    if (skeletons.empty()) {
+        return false;
+    }
 
-                for (const ::dwarf::die &subChild : child) {
-                    if (subChild.tag == ::dwarf::DW_TAG::formal_parameter) {
-                        auto *arg = new Argument();
+    std::vector<SkeletonUnit> pending;
+    pending.swap(skeletons);
 
-                        for (auto &attr : subChild.attributes()) {
-                            if (attr.first == ::dwarf::DW_AT::name) {
-                                arg->name = attr.second.as_string();
-                            }
+    std::vector<::dwarf::dwarf *> loaded;
+    try {
+        loaded = loadSplitUnits(*sections, filename, pending);
+    } catch (std::exception &e) {
+        std::cerr << "Warning: failed to read split DWARF: " << e.what() << std::endl;
+    }
+
+    for (auto split : loaded) {
+        for (auto &cu : split->compilation_units()) {
+            indexUnit(cu);
+        }
+    }
 
-                            if (attr.first == ::dwarf::DW_AT::type) {
-                                arg->typePtr = getTypePtr(attr.second.as_reference());
-                            }
-                        }
+    splitUnits.insert(splitUnits.end(), loaded.begin(), loaded.end());
+    return true;
+}
 
-                        method->args.push_back(arg);
+void DWARFExtractor::indexUnit(const ::dwarf::unit &unit, bool skeleton) {
+    try {
+        indexNode(unit.root(), "");
+    } catch (::dwarf::format_error &e) {
+        // Skeleton units use attributes libelfin can't decode, their content is indexed from the split units
+        if (!skeleton) {
+            std::cerr << "Warning: skipped DWARF unit at 0x" << std::hex << unit.get_section_offset() << std::dec
+                      << ": " << e.what() << std::endl;
+        }
+    }
+}
+
+void DWARFExtractor::indexNode(const ::dwarf::die &node, const std::string &scope) {
+    for (const ::dwarf::die &child : node) {
+        switch (child.tag) {
+            case ::dwarf::DW_TAG::class_type:
+            case ::dwarf::DW_TAG::structure_type:
+            case ::dwarf::DW_TAG::union_type:
+                indexType(child, scope);
+                indexNode(child, scope + stringAttribute(child, ::dwarf::DW_AT::name) + "::");
+                break;
+            case ::dwarf::DW_TAG::enumeration_type:
+                indexType(child, scope);
+                break;
+            case ::dwarf::DW_TAG::typedef_:
+                if (child.has(::dwarf::DW_AT::name)) {
+                    std::string name = child[::dwarf::DW_AT::name].as_string();
+                    if (typedefIndex.emplace(scope + name, TypeDefinition{child, 0, 1, {}}).second) {
+                        qualifiedNames[name].insert(scope + name);
                     }
                 }
-            }
+                break;
+            case ::dwarf::DW_TAG::namespace_:
+                indexNode(child, scope + stringAttribute(child, ::dwarf::DW_AT::name) + "::");
+                break;
+            case ::dwarf::DW_TAG::subprogram:
+                indexMethodDefinition(child);
+                indexFunction(child, scope);
+                break;
+            case ::dwarf::DW_TAG::member:
+            case ::dwarf::DW_TAG::variable:
+                indexVariable(child, scope);
+                break;
+            default:
+                break;
         }
     }
 }
 
-std::list<std::string> debugtocpp::dwarf::DWARFExtractor::getTypesList(bool showStructs) {
-    return std::list<std::string>();
+// Static members are declared in the class and defined with DW_AT_specification outside of it
+void DWARFExtractor::indexVariable(const ::dwarf::die &node, const std::string &scope) {
+    if (node.tag == ::dwarf::DW_TAG::member && !node.has(::dwarf::DW_AT::external)) {
+        return;
+    }
+
+    if (node.has(::dwarf::DW_AT::declaration) && !scope.empty()) {
+        staticMemberNames.emplace(std::make_pair(&node.get_unit(), node.get_section_offset()),
+                                  scope + stringAttribute(node, ::dwarf::DW_AT::name));
+    }
+
+    uint64_t address;
+    if (!getAddress(node, address)) {
+        return;
+    }
+
+    ::dwarf::die declaration = node.has(::dwarf::DW_AT::specification) ?
+                               node[::dwarf::DW_AT::specification].as_reference() : node;
+    staticMemberAddresses[{&declaration.get_unit(), declaration.get_section_offset()}] = address;
+
+    globalVariables.push_back({node, declaration, scope, address});
 }
 
-std::vector<Type *> DWARFExtractor::getTypes(std::list<std::string> typesList) {
-    std::vector<Type *> types;
-    // No optimization here yet
-    for (std::string &name : typesList) {
-        types.push_back(getType(name));
+// Only fixed addresses (DW_OP_addr) are resolved, locals and thread local variables are computed at runtime
+bool DWARFExtractor::getAddress(const ::dwarf::die &node, uint64_t &address) {
+    if (!node.has(::dwarf::DW_AT::location)) {
+        return false;
     }
 
-    return types;
+    ::dwarf::value location = node[::dwarf::DW_AT::location];
+    if (location.get_type() != ::dwarf::value::type::exprloc && location.get_type() != ::dwarf::value::type::block) {
+        return false;
+    }
+
+    const uint8_t DW_OP_addr = 0x03;
+    size_t addressSize = elf->get_hdr().ei_class == ::elf::elfclass::_64 ? 8 : 4;
+
+    size_t size;
+    auto expression = static_cast<const unsigned char *>(location.as_block(&size));
+    if (size != addressSize + 1 || expression[0] != DW_OP_addr) {
+        return false;
+    }
+
+    address = 0;
+    for (size_t i = 0; i < addressSize; i++) {
+        address |= static_cast<uint64_t>(expression[1 + i]) << (i * 8);
+    }
+
+    address += imageBase;
+    return true;
 }
 
-std::vector<Field *> DWARFExtractor::getAllGlobalVariables() {
-    return std::vector<Field *>();
+// Types are keyed by the name qualified with namespaces and enclosing classes, e.g. A::State and B::State
+void DWARFExtractor::indexType(const ::dwarf::die &node, const std::string &scope) {
+    if (!node.has(::dwarf::DW_AT::name) || node.has(::dwarf::DW_AT::declaration)) {
+        return;
+    }
+
+    std::string name = node[::dwarf::DW_AT::name].as_string();
+    qualifiedNames[name].insert(scope + name);
+
+    std::vector<TypeDefinition> &definitions = typeIndex[scope + name];
+    uint64_t hash = structuralHash(node);
+
+    for (auto &definition : definitions) {
+        if (definition.hash == hash) {
+            definition.copies++;
+            definition.methodVariants.emplace(methodsHash(node), node);
+            return;
+        }
+    }
+
+    definitions.push_back({node, hash, 1, {{methodsHash(node), node}}});
+}
+
+void DWARFExtractor::indexMethodDefinition(const ::dwarf::die &node) {
+    if (!node.has(::dwarf::DW_AT::specification)) {
+        return;
+    }
+
+    ::dwarf::die declaration = node[::dwarf::DW_AT::specification].as_reference();
+    if (declaration.has(::dwarf::DW_AT::linkage_name)) {
+        methodDefinitions.emplace(declaration[::dwarf::DW_AT::linkage_name].as_string(), node);
+    }
+}
+
+// Declarations in classes name the out of line definitions, definitions with code are kept for address ranges
+void DWARFExtractor::indexFunction(const ::dwarf::die &node, const std::string &scope) {
+    if (node.has(::dwarf::DW_AT::declaration)) {
+        if (!scope.empty()) {
+            methodNames.emplace(std::make_pair(&node.get_unit(), node.get_section_offset()),
+                                scope + stringAttribute(node, ::dwarf::DW_AT::name));
+        }
+        return;
+    }
+
+    if (node.has(::dwarf::DW_AT::low_pc) || node.has(::dwarf::DW_AT::ranges)) {
+        functionDefinitions.push_back({node, scope});
+    }
+}
+
+// Most common definition is used when units disagree about the type.
+// Names without their scope are accepted when only one type has that name
+const DWARFExtractor::TypeDefinition * DWARFExtractor::findDefinition(const std::string &name) {
+    buildIndex();
+
+    if (!typeIndex.count(name) && !typedefIndex.count(name) && !qualifiedNames.count(name) && indexSplitUnits()) {
+        return findDefinition(name);
+    }
+
+    auto it = typeIndex.find(name);
+    if (it == typeIndex.end()) {
+        auto alias = typedefIndex.find(name);
+        if (alias != typedefIndex.end()) {
+            return &alias->second;
+        }
+
+        auto qualified = qualifiedNames.find(name);
+        if (qualified == qualifiedNames.end() || qualified->second.count(name)) {
+            return nullptr;
+        }
+
+        if (qualified->second.size() > 1) {
+            if (reportedViolations.insert(name).second) {
+                std::cerr << "Warning: " << name << " is ambiguous, use one of:";
+                for (auto &candidate : qualified->second) {
+                    std::cerr << " " << candidate;
+                }
+                std::cerr << std::endl;
+            }
+            return nullptr;
+        }
+
+        return findDefinition(*qualified->second.begin());
+    }
+
+    std::vector<TypeDefinition> &definitions = it->second;
+    const TypeDefinition * result = &definitions.front();
+
+    for (auto &definition : definitions) {
+        if (definition.copies > result->copies) {
+            result = &definition;
+        }
+    }
+
+    if (definitions.size() > 1 && reportedViolations.insert(name).second) {
+        std::cerr << "Warning: " << name << " has " << definitions.size()
+                  << " different definitions (ODR violation?), using the most common one" << std::endl;
+    }
+
+    return result;
 }
 
 
@@ -0,0 +1,168 @@
+#include <cstring>
+#include <future>
+#include <zlib.h>
+#include "extractor/dwarf/DebugSections.hpp"
+
+namespace debugtocpp {
+namespace dwarf {
+
+namespace {
+
+const uint64_t SHF_COMPRESSED = 0x800;
+const uint32_t ELFCOMPRESS_ZLIB = 1;
+const uint32_t ELFCOMPRESS_ZSTD = 2;
+
+uint64_t readLittleEndian(const unsigned char *data, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        value |= static_cast<uint64_t>(data[i]) << (i * 8);
+    }
+
+    return value;
+}
+
+uint64_t readBigEndian(const unsigned char *data, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        value = (value << 8) | data[i];
+    }
+
+    return value;
+}
+
+void inflate(const std::string &name, const unsigned char *data, size_t size, uint64_t uncompressedSize,
+             std::string &out) {
+    out.resize(uncompressedSize);
+
+    auto outSize = static_cast<uLongf>(uncompressedSize);
+    int result = uncompress(reinterpret_cast<Bytef *>(&out[0]), &outSize, data, static_cast<uLong>(size));
+
+    if (result != Z_OK || outSize != uncompressedSize) {
+        throw ::dwarf::format_error("failed to decompress " + name);
+    }
+}
+
+}
+
+DebugSections::DebugSections(const ::elf::elf &elf) : elf(elf) {}
+
+const void *DebugSections::load(::dwarf::section_type section, size_t *size_out) {
+    std::string name = sectionName(section);
+    if (name.empty()) {
+        return nullptr;
+    }
+
+    return get(name, size_out);
+}
+
+const char *DebugSections::get(const std::string &name, size_t *size) {
+    Section &section = getSection(name);
+    std::call_once(section.loaded, &DebugSections::read, this, std::ref(section), name);
+
+    *size = section.size;
+    return section.data;
+}
+
+void DebugSections::prefetch(const std::vector<::dwarf::section_type> &sections) {
+    std::vector<std::future<void>> loading;
+
+    for (auto type : sections) {
+        loading.push_back(std::async(std::launch::async, [this, type]() {
+            size_t size;
+            load(type, &size);
+        }));
+    }
+
+    // Errors are reported again when the section is loaded by libelfin
+    for (auto &result : loading) {
+        try {
+            result.get();
+        } catch (::dwarf::format_error &e) {
+        }
+    }
+}
+
+DebugSections::Section &DebugSections::getSection(const std::string &name) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::unique_ptr<Section> &section = cache[name];
+    if (section == nullptr) {
+        section.reset(new Section);
+    }
+
+    return *section;
+}
+
+void DebugSections::read(Section &section, const std::string &name) {
+    const ::elf::section *raw = &elf.get_section(name);
+    bool legacy = false;
+
+    // Legacy compression renames .debug_* to .zdebug_*
+    if (!raw->valid() && name.compare(0, 7, ".debug_") == 0) {
+        raw = &elf.get_section(".z" + name.substr(1));
+        legacy = true;
+    }
+
+    if (!raw->valid()) {
+        return;
+    }
+
+    auto data = static_cast<const unsigned char *>(raw->data());
+    size_t size = raw->size();
+
+    if (legacy) {
+        // "ZLIB" followed by big-endian uncompressed size, sections too small to compress are left as is
+        if (size < 12 || memcmp(data, "ZLIB", 4) != 0) {
+            section.data = reinterpret_cast<const char *>(data);
+            section.size = size;
+            return;
+        }
+
+        inflate(name, data + 12, size - 12, readBigEndian(data + 4, 8), section.buffer);
+    } else if (static_cast<uint64_t>(raw->get_hdr().flags) & SHF_COMPRESSED) {
+        // Elf32_Chdr / Elf64_Chdr
+        bool is64 = elf.get_hdr().ei_class == ::elf::elfclass::_64;
+        size_t headerSize = is64 ? 24 : 12;
+
+        if (size < headerSize) {
+            throw ::dwarf::format_error("invalid compressed section " + name);
+        }
+
+        auto type = static_cast<uint32_t>(readLittleEndian(data, 4));
+        uint64_t uncompressedSize = readLittleEndian(data + (is64 ? 8 : 4), is64 ? 8 : 4);
+
+        if (type == ELFCOMPRESS_ZSTD) {
+            throw ::dwarf::format_error(name + " is compressed with zstd, which is not supported");
+        } else if (type != ELFCOMPRESS_ZLIB) {
+            throw ::dwarf::format_error("unknown compression of " + name);
+        }
+
+        inflate(name, data + headerSize, size - headerSize, uncompressedSize, section.buffer);
+    } else {
+        section.data = reinterpret_cast<const char *>(data);
+        section.size = size;
+        return;
+    }
+
+    section.data = section.buffer.data();
+    section.size = section.buffer.size();
+}
+
+std::string DebugSections::sectionName(::dwarf::section_type type) {
+    for (auto &section : elf.sections()) {
+        std::string name = section.get_name();
+        if (name.compare(0, 8, ".zdebug_") == 0) {
+            name = "." + name.substr(2);
+        }
+
+        ::dwarf::section_type sectionType;
+        if (::dwarf::elf::elf_to_dwarf_section_type(name, &sectionType) && sectionType == type) {
+            return name;
+        }
+    }
+
+    return std::string();
+}
+
+}
+}
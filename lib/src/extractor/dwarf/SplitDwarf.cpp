@@ -0,0 +1,765 @@
+#include <atomic>
+#include <fcntl.h>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+#include "extractor/dwarf/SplitDwarf.hpp"
+
+namespace debugtocpp {
+namespace dwarf {
+
+namespace {
+
+// GNU extensions used by -gsplit-dwarf with DWARF 4
+const uint64_t DW_FORM_GNU_addr_index = 0x1f01;
+const uint64_t DW_FORM_GNU_str_index = 0x1f02;
+const uint64_t DW_FORM_GNU_ref_alt = 0x1f20;
+const uint64_t DW_FORM_GNU_strp_alt = 0x1f21;
+
+const uint64_t DW_AT_GNU_dwo_name = 0x2130;
+const uint64_t DW_AT_GNU_dwo_id = 0x2131;
+const uint64_t DW_AT_GNU_addr_base = 0x2133;
+const uint64_t DW_AT_lo_user = 0x2000;
+
+// Column identifiers of .debug_cu_index
+const uint32_t DW_SECT_INFO = 1;
+const uint32_t DW_SECT_ABBREV = 3;
+const uint32_t DW_SECT_STR_OFFSETS = 6;
+
+// Form used in converted units, 0 drops the attribute
+const uint64_t FORM_DROP = 0;
+
+struct Slice {
+    const char *data = nullptr;
+    size_t size = 0;
+};
+
+class Reader {
+public:
+    Reader(Slice slice, size_t pos = 0) : slice(slice), pos(pos) {}
+
+    Slice slice;
+    size_t pos;
+
+    bool end() const {
+        return pos >= slice.size;
+    }
+
+    uint64_t fixed(size_t bytes) {
+        check(bytes);
+
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; i++) {
+            value |= static_cast<uint64_t>(static_cast<unsigned char>(slice.data[pos + i])) << (i * 8);
+        }
+
+        pos += bytes;
+        return value;
+    }
+
+    uint64_t uleb() {
+        uint64_t value = 0;
+        int shift = 0;
+
+        while (true) {
+            auto byte = static_cast<unsigned char>(fixed(1));
+            if (shift < 64) {
+                value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            }
+            shift += 7;
+
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+    }
+
+    void sleb() {
+        while (fixed(1) & 0x80) {}
+    }
+
+    std::string cstr() {
+        size_t start = pos;
+        while (fixed(1) != 0) {}
+
+        return std::string(slice.data + start, pos - start - 1);
+    }
+
+    void skip(uint64_t bytes) {
+        check(bytes);
+        pos += bytes;
+    }
+
+private:
+    void check(uint64_t bytes) {
+        if (bytes > slice.size || pos > slice.size - bytes) {
+            throw ::dwarf::format_error("unexpected end of split DWARF section");
+        }
+    }
+};
+
+struct AttributeSpec {
+    uint64_t name;
+    uint64_t form;
+};
+
+struct Abbrev {
+    uint64_t tag;
+    bool children;
+    std::vector<AttributeSpec> attributes;
+};
+
+typedef std::map<uint64_t, Abbrev> AbbrevTable;
+
+struct UnitHeader {
+    uint64_t offset;
+    uint64_t end;
+    size_t offsetSize;
+    uint16_t version;
+    uint64_t abbrevOffset;
+    size_t addressSize;
+    size_t diesOffset;
+};
+
+AbbrevTable readAbbrevs(Slice abbrevs, uint64_t offset) {
+    AbbrevTable table;
+    Reader reader(abbrevs, offset);
+
+    while (true) {
+        uint64_t code = reader.uleb();
+        if (code == 0) {
+            return table;
+        }
+
+        Abbrev &abbrev = table[code];
+        abbrev.tag = reader.uleb();
+        abbrev.children = reader.fixed(1) != 0;
+
+        while (true) {
+            AttributeSpec spec{};
+            spec.name = reader.uleb();
+            spec.form = reader.uleb();
+
+            if (spec.name == 0 && spec.form == 0) {
+                break;
+            }
+
+            abbrev.attributes.push_back(spec);
+        }
+    }
+}
+
+bool isSupported(const UnitHeader &header) {
+    return header.version >= 2 && header.version <= 4;
+}
+
+bool isSkeleton(const Abbrev &root) {
+    for (auto &spec : root.attributes) {
+        if (spec.name == DW_AT_GNU_dwo_name) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+UnitHeader readUnitHeader(Reader &reader) {
+    UnitHeader header{};
+    header.offset = reader.pos;
+    header.offsetSize = 4;
+
+    uint64_t length = reader.fixed(4);
+    if (length == 0xffffffff) {
+        header.offsetSize = 8;
+        length = reader.fixed(8);
+    }
+
+    header.end = reader.pos + length;
+    if (header.end > reader.slice.size) {
+        throw ::dwarf::format_error("split DWARF unit exceeds section");
+    }
+
+    // DWARF 5 headers have a different layout, only their end is known
+    header.version = static_cast<uint16_t>(reader.fixed(2));
+    if (!isSupported(header)) {
+        return header;
+    }
+
+    header.abbrevOffset = reader.fixed(header.offsetSize);
+    header.addressSize = reader.fixed(1);
+    header.diesOffset = reader.pos;
+
+    return header;
+}
+
+void requireSupported(const UnitHeader &header) {
+    if (!isSupported(header)) {
+        throw ::dwarf::format_error("unsupported split DWARF version " + std::to_string(header.version));
+    }
+}
+
+void skipForm(Reader &reader, uint64_t form, const UnitHeader &unit) {
+    switch (form) {
+        case 0x01: reader.skip(unit.addressSize); break;                // addr
+        case 0x03: reader.skip(reader.fixed(2)); break;                 // block2
+        case 0x04: reader.skip(reader.fixed(4)); break;                 // block4
+        case 0x05: reader.skip(2); break;                               // data2
+        case 0x06: reader.skip(4); break;                               // data4
+        case 0x07: reader.skip(8); break;                               // data8
+        case 0x08: reader.cstr(); break;                                // string
+        case 0x09: reader.skip(reader.uleb()); break;                   // block
+        case 0x0a: reader.skip(reader.fixed(1)); break;                 // block1
+        case 0x0b: reader.skip(1); break;                               // data1
+        case 0x0c: reader.skip(1); break;                               // flag
+        case 0x0d: reader.sleb(); break;                                // sdata
+        case 0x0e: reader.skip(unit.offsetSize); break;                 // strp
+        case 0x0f: reader.uleb(); break;                                // udata
+        case 0x10: reader.skip(unit.version <= 2 ? unit.addressSize : unit.offsetSize); break; // ref_addr
+        case 0x11: reader.skip(1); break;                               // ref1
+        case 0x12: reader.skip(2); break;                               // ref2
+        case 0x13: reader.skip(4); break;                               // ref4
+        case 0x14: reader.skip(8); break;                               // ref8
+        case 0x15: reader.uleb(); break;                                // ref_udata
+        case 0x16: skipForm(reader, reader.uleb(), unit); break;        // indirect
+        case 0x17: reader.skip(unit.offsetSize); break;                 // sec_offset
+        case 0x18: reader.skip(reader.uleb()); break;                   // exprloc
+        case 0x19: break;                                               // flag_present
+        case 0x20: reader.skip(8); break;                               // ref_sig8
+        case DW_FORM_GNU_addr_index: reader.uleb(); break;
+        case DW_FORM_GNU_str_index: reader.uleb(); break;
+        case DW_FORM_GNU_ref_alt: reader.skip(unit.offsetSize); break;
+        case DW_FORM_GNU_strp_alt: reader.skip(unit.offsetSize); break;
+        default:
+            throw ::dwarf::format_error("unknown attribute form " + std::to_string(form));
+    }
+}
+
+bool isUnitReference(uint64_t form) {
+    return form == 0x11 || form == 0x12 || form == 0x13 || form == 0x14 || form == 0x15;
+}
+
+uint64_t convertForm(const AttributeSpec &spec) {
+    if (spec.form == DW_FORM_GNU_str_index) {
+        return 0x0e;
+    } else if (spec.form == DW_FORM_GNU_addr_index) {
+        return 0x01;
+    } else if (isUnitReference(spec.form)) {
+        // Offsets move during conversion, one fixed size keeps them easy to patch
+        return 0x13;
+    } else if (spec.form == 0x16) {
+        throw ::dwarf::format_error("DW_FORM_indirect is not supported in split DWARF");
+    } else if (spec.form == 0x17 && spec.name >= DW_AT_lo_user) {
+        // libelfin rejects section offsets of vendor attributes (DW_AT_GNU_addr_base, DW_AT_GNU_ranges_base...)
+        return FORM_DROP;
+    }
+
+    return spec.form;
+}
+
+size_t convertedSize(uint64_t form, const UnitHeader &unit, size_t originalSize) {
+    switch (form) {
+        case FORM_DROP: return 0;
+        case 0x01: return unit.addressSize;
+        case 0x0e: return unit.offsetSize;
+        case 0x13: return 4;
+        default: return originalSize;
+    }
+}
+
+void put(std::string &out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        out += static_cast<char>((value >> (i * 8)) & 0xff);
+    }
+}
+
+void putUleb(std::string &out, uint64_t value) {
+    do {
+        auto byte = static_cast<char>(value & 0x7f);
+        value >>= 7;
+        out += static_cast<char>(value != 0 ? byte | 0x80 : byte);
+    } while (value != 0);
+}
+
+void writeAbbrevs(std::string &out, const AbbrevTable &table) {
+    for (auto &entry : table) {
+        putUleb(out, entry.first);
+        putUleb(out, entry.second.tag);
+        out += static_cast<char>(entry.second.children ? 1 : 0);
+
+        for (auto &spec : entry.second.attributes) {
+            uint64_t form = convertForm(spec);
+            if (form != FORM_DROP) {
+                putUleb(out, spec.name);
+                putUleb(out, form);
+            }
+        }
+
+        putUleb(out, 0);
+        putUleb(out, 0);
+    }
+
+    putUleb(out, 0);
+}
+
+Slice section(DebugSections &sections, const std::string &name) {
+    Slice slice;
+    slice.data = sections.get(name, &slice.size);
+
+    return slice;
+}
+
+Slice subSlice(Slice slice, uint64_t offset, uint64_t size) {
+    if (offset > slice.size || size > slice.size - offset) {
+        throw ::dwarf::format_error("split DWARF contribution exceeds section");
+    }
+
+    return Slice{slice.data + offset, static_cast<size_t>(size)};
+}
+
+// Sections of a single split unit, in a .dwp they are contributions of the package sections
+struct SplitSections {
+    Slice info;
+    Slice abbrev;
+    Slice strOffsets;
+    Slice str;
+};
+
+struct SplitJob {
+    std::shared_ptr<DebugSections> file;
+    SplitSections sections;
+    uint64_t addrBase;
+    std::string name;
+};
+
+class SplitLoader : public ::dwarf::loader {
+public:
+    SplitLoader(std::shared_ptr<DebugSections> file, std::string info, std::string abbrev, Slice str)
+            : file(std::move(file)), info(std::move(info)), abbrev(std::move(abbrev)), str(str) {}
+
+    const void *load(::dwarf::section_type section, size_t *size_out) override {
+        switch (section) {
+            case ::dwarf::section_type::info:
+                *size_out = info.size();
+                return info.data();
+            case ::dwarf::section_type::abbrev:
+                *size_out = abbrev.size();
+                return abbrev.data();
+            case ::dwarf::section_type::str:
+                *size_out = str.size;
+                return str.data;
+            default:
+                return nullptr;
+        }
+    }
+
+private:
+    std::shared_ptr<DebugSections> file;
+    std::string info;
+    std::string abbrev;
+    Slice str;
+};
+
+// Rewrites one unit: string and address indexes are resolved, unit references are remapped to new offsets
+void convertUnit(Reader &reader, const SplitSections &sections, Slice addr, uint64_t addrBase,
+                 std::string &info, std::string &abbrev) {
+    UnitHeader unit = readUnitHeader(reader);
+    requireSupported(unit);
+    AbbrevTable table = readAbbrevs(sections.abbrev, unit.abbrevOffset);
+
+    uint64_t abbrevOffset = abbrev.size();
+    writeAbbrevs(abbrev, table);
+
+    // First pass computes where every DIE ends up
+    std::map<uint64_t, uint64_t> offsets;
+    size_t headerSize = unit.diesOffset - unit.offset;
+    uint64_t newPos = headerSize;
+
+    Reader dies(reader.slice, unit.diesOffset);
+    while (dies.pos < unit.end) {
+        offsets[dies.pos - unit.offset] = newPos;
+
+        size_t start = dies.pos;
+        uint64_t code = dies.uleb();
+        newPos += dies.pos - start;
+
+        if (code == 0) {
+            continue;
+        }
+
+        auto it = table.find(code);
+        if (it == table.end()) {
+            throw ::dwarf::format_error("unknown abbreviation code " + std::to_string(code));
+        }
+
+        for (auto &spec : it->second.attributes) {
+            size_t attrStart = dies.pos;
+            skipForm(dies, spec.form, unit);
+            newPos += convertedSize(convertForm(spec), unit, dies.pos - attrStart);
+        }
+    }
+
+    auto remap = [&offsets](uint64_t offset) {
+        auto it = offsets.find(offset);
+        if (it == offsets.end()) {
+            throw ::dwarf::format_error("reference to unknown DIE in split DWARF unit");
+        }
+
+        return it->second;
+    };
+
+    uint64_t newUnitOffset = info.size();
+    size_t lengthSize = unit.offsetSize == 8 ? 12 : 4;
+    if (unit.offsetSize == 8) {
+        put(info, 0xffffffff, 4);
+    }
+    put(info, newPos - lengthSize, unit.offsetSize);
+    put(info, unit.version, 2);
+    put(info, abbrevOffset, unit.offsetSize);
+    put(info, unit.addressSize, 1);
+
+    // Second pass writes converted DIEs
+    dies.pos = unit.diesOffset;
+    while (dies.pos < unit.end) {
+        size_t start = dies.pos;
+        uint64_t code = dies.uleb();
+        info.append(dies.slice.data + start, dies.pos - start);
+
+        if (code == 0) {
+            continue;
+        }
+
+        for (auto &spec : table[code].attributes) {
+            uint64_t form = convertForm(spec);
+            size_t attrStart = dies.pos;
+
+            if (spec.form == DW_FORM_GNU_str_index) {
+                Reader strOffsets(sections.strOffsets, dies.uleb() * unit.offsetSize);
+                put(info, strOffsets.fixed(unit.offsetSize), unit.offsetSize);
+            } else if (spec.form == DW_FORM_GNU_addr_index) {
+                uint64_t index = dies.uleb();
+                uint64_t address = 0;
+
+                if (addr.data != nullptr) {
+                    Reader addresses(addr, addrBase + index * unit.addressSize);
+                    address = addresses.fixed(unit.addressSize);
+                }
+
+                put(info, address, unit.addressSize);
+            } else if (isUnitReference(spec.form)) {
+                uint64_t offset = spec.form == 0x15 ? dies.uleb() : dies.fixed(spec.form == 0x11 ? 1 :
+                                                                              spec.form == 0x12 ? 2 :
+                                                                              spec.form == 0x13 ? 4 : 8);
+                put(info, remap(offset), 4);
+            } else if (spec.form == 0x10 && unit.version > 2) {
+                uint64_t offset = dies.fixed(unit.offsetSize);
+                if (offset >= unit.offset && offset < unit.end) {
+                    offset = newUnitOffset + remap(offset - unit.offset);
+                }
+
+                put(info, offset, unit.offsetSize);
+            } else {
+                skipForm(dies, spec.form, unit);
+                if (form != FORM_DROP) {
+                    info.append(dies.slice.data + attrStart, dies.pos - attrStart);
+                }
+            }
+        }
+    }
+
+    reader.pos = unit.end;
+}
+
+::dwarf::dwarf * loadSplitUnit(const SplitJob &job, Slice addr) {
+    std::string info;
+    std::string abbrev;
+
+    Reader reader(job.sections.info);
+    while (!reader.end()) {
+        convertUnit(reader, job.sections, addr, job.addrBase, info, abbrev);
+    }
+
+    auto loader = std::make_shared<SplitLoader>(job.file, std::move(info), std::move(abbrev), job.sections.str);
+    auto * dwarf = new ::dwarf::dwarf(loader);
+
+    // Parse unit headers now, while still running in parallel
+    dwarf->compilation_units();
+    return dwarf;
+}
+
+std::shared_ptr<DebugSections> openElf(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    return std::make_shared<DebugSections>(::elf::elf(::elf::create_mmap_loader(fd)));
+}
+
+bool fileExists(const std::string &path) {
+    return access(path.c_str(), R_OK) == 0;
+}
+
+std::string directoryOf(const std::string &path) {
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? "." : path.substr(0, slash);
+}
+
+std::string findDwoFile(const SkeletonUnit &unit, const std::string &binaryDirectory) {
+    std::vector<std::string> candidates;
+
+    if (!unit.dwoName.empty() && unit.dwoName[0] == '/') {
+        candidates.push_back(unit.dwoName);
+    } else {
+        if (!unit.compDir.empty()) {
+            candidates.push_back(unit.compDir + "/" + unit.dwoName);
+        }
+        candidates.push_back(binaryDirectory + "/" + unit.dwoName);
+    }
+
+    size_t slash = unit.dwoName.find_last_of('/');
+    if (slash != std::string::npos) {
+        candidates.push_back(binaryDirectory + "/" + unit.dwoName.substr(slash + 1));
+    }
+
+    for (auto &candidate : candidates) {
+        if (fileExists(candidate)) {
+            return candidate;
+        }
+    }
+
+    return std::string();
+}
+
+SplitSections dwoSections(DebugSections &elf) {
+    SplitSections sections;
+    sections.info = section(elf, ".debug_info.dwo");
+    sections.abbrev = section(elf, ".debug_abbrev.dwo");
+    sections.strOffsets = section(elf, ".debug_str_offsets.dwo");
+    sections.str = section(elf, ".debug_str.dwo");
+
+    return sections;
+}
+
+// Reads contributions of every unit in .debug_cu_index (version 2), keyed by dwo id
+std::map<uint64_t, SplitSections> readPackageIndex(DebugSections &elf) {
+    std::map<uint64_t, SplitSections> units;
+    SplitSections shared = dwoSections(elf);
+
+    Reader reader(section(elf, ".debug_cu_index"));
+    if (reader.end()) {
+        return units;
+    }
+
+    uint32_t version = static_cast<uint32_t>(reader.fixed(4));
+    if (version != 2) {
+        throw ::dwarf::format_error("unsupported .dwp index version " + std::to_string(version));
+    }
+
+    auto columns = static_cast<uint32_t>(reader.fixed(4));
+    auto rows = static_cast<uint32_t>(reader.fixed(4));
+    auto slots = static_cast<uint32_t>(reader.fixed(4));
+
+    size_t signatures = reader.pos;
+    size_t indexes = signatures + slots * 8ULL;
+    size_t sectionIds = indexes + slots * 4ULL;
+    size_t offsets = sectionIds + columns * 4ULL;
+    size_t sizes = offsets + rows * columns * 4ULL;
+
+    std::vector<uint32_t> ids;
+    reader.pos = sectionIds;
+    for (uint32_t i = 0; i < columns; i++) {
+        ids.push_back(static_cast<uint32_t>(reader.fixed(4)));
+    }
+
+    for (uint32_t slot = 0; slot < slots; slot++) {
+        reader.pos = indexes + slot * 4ULL;
+        auto row = static_cast<uint32_t>(reader.fixed(4));
+        if (row == 0 || row > rows) {
+            continue;
+        }
+
+        reader.pos = signatures + slot * 8ULL;
+        uint64_t signature = reader.fixed(8);
+
+        SplitSections sections = shared;
+        for (uint32_t column = 0; column < columns; column++) {
+            reader.pos = offsets + ((row - 1) * columns + column) * 4ULL;
+            uint64_t offset = reader.fixed(4);
+            reader.pos = sizes + ((row - 1) * columns + column) * 4ULL;
+            uint64_t size = reader.fixed(4);
+
+            if (ids[column] == DW_SECT_INFO) {
+                sections.info = subSlice(shared.info, offset, size);
+            } else if (ids[column] == DW_SECT_ABBREV) {
+                sections.abbrev = subSlice(shared.abbrev, offset, size);
+            } else if (ids[column] == DW_SECT_STR_OFFSETS) {
+                sections.strOffsets = subSlice(shared.strOffsets, offset, size);
+            }
+        }
+
+        units[signature] = sections;
+    }
+
+    return units;
+}
+
+}
+
+std::vector<SkeletonUnit> findSkeletonUnits(DebugSections &elf) {
+    std::vector<SkeletonUnit> skeletons;
+    std::map<uint64_t, AbbrevTable> abbrevTables;
+
+    Slice abbrevs = section(elf, ".debug_abbrev");
+    Slice str = section(elf, ".debug_str");
+    Reader reader(section(elf, ".debug_info"));
+
+    auto readString = [&str](Reader &r, uint64_t form, const UnitHeader &unit) {
+        if (form == 0x08) {
+            return r.cstr();
+        }
+
+        Reader strings(str, r.fixed(unit.offsetSize));
+        return strings.cstr();
+    };
+
+    while (!reader.end()) {
+        UnitHeader unit = readUnitHeader(reader);
+        reader.pos = unit.end;
+
+        // GNU skeletons are DWARF 4 units, DWARF 5 units are left to libelfin
+        if (!isSupported(unit)) {
+            continue;
+        }
+
+        if (!abbrevTables.count(unit.abbrevOffset)) {
+            abbrevTables[unit.abbrevOffset] = readAbbrevs(abbrevs, unit.abbrevOffset);
+        }
+
+        // Only the unit root is needed, roots of other units are not decoded
+        Reader root(reader.slice, unit.diesOffset);
+        auto it = abbrevTables[unit.abbrevOffset].find(root.uleb());
+        if (it == abbrevTables[unit.abbrevOffset].end() || !isSkeleton(it->second)) {
+            continue;
+        }
+
+        SkeletonUnit skeleton;
+        skeleton.unitOffset = unit.offset;
+        for (auto &spec : it->second.attributes) {
+            if (spec.name == DW_AT_GNU_dwo_name && (spec.form == 0x08 || spec.form == 0x0e)) {
+                skeleton.dwoName = readString(root, spec.form, unit);
+            } else if (spec.name == 0x1b && (spec.form == 0x08 || spec.form == 0x0e)) {
+                skeleton.compDir = readString(root, spec.form, unit);
+            } else if (spec.name == DW_AT_GNU_dwo_id && spec.form == 0x07) {
+                skeleton.dwoId = root.fixed(8);
+            } else if (spec.name == DW_AT_GNU_addr_base && spec.form == 0x17) {
+                skeleton.addrBase = root.fixed(unit.offsetSize);
+            } else {
+                skipForm(root, spec.form, unit);
+            }
+        }
+
+        if (!skeleton.dwoName.empty()) {
+            skeletons.push_back(skeleton);
+        }
+    }
+
+    return skeletons;
+}
+
+// Type unit headers continue with the type signature and the offset of the type
+std::vector<uint64_t> findTypeUnitSignatures(DebugSections &elf) {
+    std::vector<uint64_t> signatures;
+    Reader reader(section(elf, ".debug_types"));
+
+    while (!reader.end()) {
+        UnitHeader unit = readUnitHeader(reader);
+        requireSupported(unit);
+        signatures.push_back(reader.fixed(8));
+
+        reader.pos = unit.end;
+    }
+
+    return signatures;
+}
+
+std::vector<::dwarf::dwarf *> loadSplitUnits(DebugSections &elf, const std::string &filename,
+                                             const std::vector<SkeletonUnit> &skeletons) {
+    std::vector<SplitJob> jobs;
+    std::map<uint64_t, uint64_t> addrBases;
+
+    for (auto &skeleton : skeletons) {
+        addrBases[skeleton.dwoId] = skeleton.addrBase;
+    }
+
+    // Package built by dwp contains all units, otherwise every unit has its own .dwo file
+    std::string packagePath = filename + ".dwp";
+    if (fileExists(packagePath)) {
+        std::shared_ptr<DebugSections> package = openElf(packagePath);
+
+        for (auto &unit : readPackageIndex(*package)) {
+            auto base = addrBases.find(unit.first);
+            if (base != addrBases.end()) {
+                jobs.push_back({package, unit.second, base->second, packagePath});
+            }
+        }
+    } else {
+        std::string binaryDirectory = directoryOf(filename);
+
+        for (auto &skeleton : skeletons) {
+            std::string path = findDwoFile(skeleton, binaryDirectory);
+            if (path.empty()) {
+                std::cerr << "Warning: split DWARF file not found: " << skeleton.dwoName << std::endl;
+                continue;
+            }
+
+            std::shared_ptr<DebugSections> file;
+            try {
+                file = openElf(path);
+            } catch (::elf::format_error &e) {
+                std::cerr << "Warning: " << path << ": " << e.what() << std::endl;
+            }
+
+            if (file != nullptr) {
+                jobs.push_back({file, dwoSections(*file), skeleton.addrBase, path});
+            }
+        }
+    }
+
+    Slice addr = section(elf, ".debug_addr");
+    std::vector<::dwarf::dwarf *> loaded(jobs.size(), nullptr);
+    std::atomic<size_t> next(0);
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < jobs.size(); i = next++) {
+            try {
+                loaded[i] = loadSplitUnit(jobs[i], addr);
+            } catch (std::exception &e) {
+                std::cerr << "Warning: " << jobs[i].name << ": " << e.what() << std::endl;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    size_t threadCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), jobs.size());
+    for (size_t i = 0; i < threadCount; i++) {
+        threads.emplace_back(worker);
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::vector<::dwarf::dwarf *> units;
+    for (auto unit : loaded) {
+        if (unit != nullptr) {
+            units.push_back(unit);
+        }
+    }
+
+    return units;
+}
+
+}
+}
@@ -17,6 +17,9 @@ ExtractResult debugtocpp::elf::ELFExtractor::load(std::string filename, int imag
 
     try {
         elf = new ::elf::elf(::elf::create_mmap_loader(fd));
+
+        // Addresses of position independent binaries are relative to the load address
+        imageBase = elf->get_hdr().type == ::elf::et::dyn ? static_cast<uint64_t>(image_base) : 0;
     } catch (::elf::format_error& e) {
         if (strcmp(e.what(), "bad ELF magic number") == 0) {
             return ExtractResult::INVALID_FILE;
@@ -117,7 +120,7 @@ std::vector<Type *> ELFExtractor::getTypes(std::list<std::string> typesList) {
 
                 auto * field = new Field(fieldName, fieldType, 0);
                 field->isStatic = true;
-                field->address = data.value;
+                field->address = imageBase + data.value;
                 field->accessibility = Accessibility::PUBLIC;
 
                 type->fields.push_back(field);
@@ -173,7 +176,7 @@ Method *ELFExtractor::getMethod(::elf::sym *sym) {
         method->returnType = new TypePtr("int", (bool) cname->return_type.is_pointer); // TODO other types?
     }
 
-    method->address = data.value;
+    method->address = imageBase + data.value;
     method->callType = cname->function_call; // inne wartości
     method->isStatic = cname->is_static;
     method->isVirtual = cname->is_virtual;
@@ -378,7 +381,7 @@ std::vector<Field *> ELFExtractor::getAllGlobalVariables() {
         auto name = !demangled.empty() ? demangled : sym.get_name();
         auto * field = new Field(name, fieldType, 0);
         field->isStatic = true;
-        field->address = data.value;
+        field->address = imageBase + data.value;
         field->accessibility = Accessibility::PUBLIC;
 
         fields.push_back(field);
@@ -387,5 +390,29 @@ std::vector<Field *> ELFExtractor::getAllGlobalVariables() {
     return fields;
 }
 
+// Sizes are st_size of symbols, names are demangled without parameters as in method names
+std::vector<AddressRange> ELFExtractor::getAddressRanges() {
+    std::vector<AddressRange> ranges;
+
+    for (auto sym : symtab) {
+        auto &data = sym.get_data();
+        if ((data.type() != ::elf::stt::func && data.type() != ::elf::stt::object) || data.value == 0) {
+            continue;
+        }
+
+        auto cname = demangler->demangleToClass(sym.get_name());
+
+        AddressRange range;
+        range.start = imageBase + data.value;
+        range.size = data.size;
+        range.name = !cname->name.empty() ? cname->printname(cname->name) : sym.get_name();
+        range.isFunction = data.type() == ::elf::stt::func;
+
+        ranges.push_back(range);
+    }
+
+    return ranges;
+}
+
 }
 }
\ No newline at end of file
@@ -0,0 +1,361 @@
+#include <map>
+#include "extractor/pdb/CodeView.hpp"
+
+namespace debugtocpp {
+namespace pdb {
+
+namespace {
+
+const uint8_t LF_PAD0 = 0xf0;
+
+struct SimpleType {
+    const char *name;
+    uint32_t size;
+};
+
+// Kind of simple type is in the low byte, the next 4 bits are pointer mode
+const std::map<uint32_t, SimpleType> simpleTypes = {
+        {0x0003, {"void", 0}},
+        {0x0008, {"HRESULT", 4}},
+        {0x0010, {"signed char", 1}},
+        {0x0020, {"unsigned char", 1}},
+        {0x0068, {"__int8", 1}},
+        {0x0069, {"unsigned __int8", 1}},
+        {0x0070, {"char", 1}},
+        {0x0071, {"wchar_t", 2}},
+        {0x007a, {"char16_t", 2}},
+        {0x007b, {"char32_t", 4}},
+        {0x007c, {"char8_t", 1}},
+        {0x0011, {"short", 2}},
+        {0x0021, {"unsigned short", 2}},
+        {0x0072, {"short", 2}},
+        {0x0073, {"unsigned short", 2}},
+        {0x0012, {"long", 4}},
+        {0x0022, {"unsigned long", 4}},
+        {0x0074, {"int", 4}},
+        {0x0075, {"unsigned int", 4}},
+        {0x0013, {"__int64", 8}},
+        {0x0023, {"unsigned __int64", 8}},
+        {0x0076, {"__int64", 8}},
+        {0x0077, {"unsigned __int64", 8}},
+        {0x0014, {"__int128", 16}},
+        {0x0024, {"unsigned __int128", 16}},
+        {0x0078, {"__int128", 16}},
+        {0x0079, {"unsigned __int128", 16}},
+        {0x0046, {"_Float16", 2}},
+        {0x0040, {"float", 4}},
+        {0x0041, {"double", 8}},
+        {0x0042, {"long double", 10}},
+        {0x0030, {"bool", 1}},
+        {0x0031, {"__bool16", 2}},
+        {0x0032, {"__bool32", 4}},
+        {0x0033, {"__bool64", 8}}
+};
+
+bool hasVftableOffset(uint16_t attributes) {
+    uint16_t property = (attributes >> 2) & 0x7;
+    return property == METHOD_INTRO_VIRTUAL || property == METHOD_PURE_INTRO_VIRTUAL;
+}
+
+}
+
+int64_t RecordReader::numeric() {
+    uint16_t leaf = u16();
+    if (leaf < LF_NUMERIC) {
+        return leaf;
+    }
+
+    switch (leaf) {
+        case LF_CHAR:
+            return static_cast<int8_t>(u8());
+        case LF_SHORT:
+            return static_cast<int16_t>(u16());
+        case LF_USHORT:
+            return u16();
+        case LF_LONG:
+            return i32();
+        case LF_ULONG:
+            return u32();
+        case LF_QUADWORD:
+        case LF_UQUADWORD:
+            return read<int64_t>();
+        default:
+            throw std::string("Unsupported numeric leaf in PDB record");
+    }
+}
+
+std::string RecordReader::string() {
+    auto terminator = static_cast<const char *>(memchr(data, '\0', remaining()));
+    if (terminator == nullptr) {
+        throw std::string("Unterminated string in PDB record");
+    }
+
+    std::string value(data, terminator);
+    data = terminator + 1;
+
+    return value;
+}
+
+void RecordReader::skip(size_t size) {
+    if (size > remaining()) {
+        throw std::string("Truncated PDB record");
+    }
+
+    data += size;
+}
+
+// Members of field lists are aligned to 4 bytes with LF_PAD1..LF_PAD3
+void RecordReader::skipPadding() {
+    while (data < end && static_cast<uint8_t>(*data) > LF_PAD0) {
+        data++;
+    }
+}
+
+bool isUdt(uint16_t kind) {
+    return kind == LF_CLASS || kind == LF_STRUCTURE || kind == LF_INTERFACE || kind == LF_UNION || kind == LF_ENUM;
+}
+
+UdtRecord readUdt(uint16_t kind, RecordReader reader) {
+    UdtRecord udt;
+    udt.kind = kind;
+
+    reader.u16(); // Member count
+    udt.properties = reader.u16();
+
+    if (kind == LF_ENUM) {
+        udt.underlyingType = reader.u32();
+        udt.fieldList = reader.u32();
+    } else {
+        udt.fieldList = reader.u32();
+
+        // Derivation list and vtable shape
+        if (kind != LF_UNION) {
+            reader.skip(8);
+        }
+
+        udt.size = static_cast<uint64_t>(reader.numeric());
+    }
+
+    udt.name = reader.string();
+    if (udt.properties & PROPERTY_HAS_UNIQUE_NAME) {
+        udt.uniqueName = reader.string();
+    }
+
+    return udt;
+}
+
+ProcedureRecord readProcedure(uint16_t kind, RecordReader reader) {
+    ProcedureRecord procedure;
+    procedure.returnType = reader.u32();
+
+    if (kind == LF_MFUNCTION) {
+        procedure.classType = reader.u32();
+        procedure.thisType = reader.u32();
+    }
+
+    procedure.callingConvention = reader.u8();
+    reader.u8(); // Function attributes
+    reader.u16(); // Parameter count, also in argument list
+    procedure.argumentList = reader.u32();
+
+    return procedure;
+}
+
+FunctionIdRecord readFunctionId(uint16_t kind, RecordReader reader) {
+    FunctionIdRecord function;
+
+    // Scope of LF_FUNC_ID is a string id, not a type
+    uint32_t scope = reader.u32();
+    if (kind == LF_MFUNC_ID) {
+        function.parentType = scope;
+    }
+
+    function.type = reader.u32();
+    function.name = reader.string();
+
+    return function;
+}
+
+MemberRecord readMember(RecordReader &reader) {
+    MemberRecord member;
+    member.kind = reader.u16();
+
+    switch (member.kind) {
+        case LF_BCLASS:
+            member.attributes = reader.u16();
+            member.type = reader.u32();
+            member.offset = reader.numeric();
+            break;
+        case LF_VBCLASS:
+        case LF_IVBCLASS:
+            member.attributes = reader.u16();
+            member.type = reader.u32();
+            reader.u32(); // Virtual base pointer type
+            reader.numeric();
+            reader.numeric();
+            break;
+        case LF_ENUMERATE:
+            member.attributes = reader.u16();
+            member.offset = reader.numeric();
+            member.name = reader.string();
+            break;
+        case LF_MEMBER:
+            member.attributes = reader.u16();
+            member.type = reader.u32();
+            member.offset = reader.numeric();
+            member.name = reader.string();
+            break;
+        case LF_STMEMBER:
+            member.attributes = reader.u16();
+            member.type = reader.u32();
+            member.name = reader.string();
+            break;
+        case LF_METHOD:
+            reader.u16(); // Overload count
+            member.type = reader.u32(); // LF_METHODLIST
+            member.name = reader.string();
+            break;
+        case LF_NESTTYPE:
+            reader.u16();
+            member.type = reader.u32();
+            member.name = reader.string();
+            break;
+        case LF_VFUNCTAB:
+        case LF_INDEX:
+            reader.u16();
+            member.type = reader.u32();
+            break;
+        case LF_ONEMETHOD:
+            member.attributes = reader.u16();
+            member.type = reader.u32();
+            if (hasVftableOffset(member.attributes)) {
+                member.vftableOffset = reader.i32();
+            }
+            member.name = reader.string();
+            break;
+        default:
+            throw std::string("Unknown member kind " + std::to_string(member.kind) + " in PDB field list");
+    }
+
+    reader.skipPadding();
+    return member;
+}
+
+MemberRecord readMethodListEntry(RecordReader &reader) {
+    MemberRecord method;
+    method.kind = LF_ONEMETHOD;
+    method.attributes = reader.u16();
+    reader.u16();
+    method.type = reader.u32();
+
+    if (hasVftableOffset(method.attributes)) {
+        method.vftableOffset = reader.i32();
+    }
+
+    return method;
+}
+
+ProcedureSymbol readProcedureSymbol(RecordReader reader) {
+    ProcedureSymbol procedure;
+
+    reader.skip(3 * sizeof(uint32_t)); // Parent, end and next
+    procedure.length = reader.u32();
+    reader.skip(2 * sizeof(uint32_t)); // Debug start and end
+    procedure.type = reader.u32();
+    procedure.offset = reader.u32();
+    procedure.segment = reader.u16();
+    reader.u8(); // Flags
+    procedure.name = reader.string();
+
+    return procedure;
+}
+
+DataSymbol readDataSymbol(RecordReader reader) {
+    DataSymbol data;
+
+    data.type = reader.u32();
+    data.offset = reader.u32();
+    data.segment = reader.u16();
+    data.name = reader.string();
+
+    return data;
+}
+
+bool isScopeSymbol(uint16_t kind) {
+    switch (kind) {
+        case S_GPROC32:
+        case S_LPROC32:
+        case S_GPROC32_ID:
+        case S_LPROC32_ID:
+        case S_THUNK32:
+        case S_BLOCK32:
+        case S_WITH32:
+        case S_SEPCODE:
+        case S_INLINESITE:
+        case S_INLINESITE2:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool isScopeEndSymbol(uint16_t kind) {
+    return kind == S_END || kind == S_PROC_ID_END || kind == S_INLINESITE_END;
+}
+
+std::string getSimpleTypeName(uint32_t index) {
+    auto it = simpleTypes.find(index & 0xff);
+    return it != simpleTypes.end() ? it->second.name : "<unknown type>";
+}
+
+uint32_t getSimpleTypeSize(uint32_t index) {
+    switch ((index >> 8) & 0xf) {
+        case 0: {
+            auto it = simpleTypes.find(index & 0xff);
+            return it != simpleTypes.end() ? it->second.size : 0;
+        }
+        case 1:
+            return 2;
+        case 5:
+            return 6;
+        case 6:
+            return 8;
+        case 7:
+            return 16;
+        default:
+            return 4;
+    }
+}
+
+bool isSimpleTypePointer(uint32_t index) {
+    return ((index >> 8) & 0xf) != 0;
+}
+
+uint32_t hashStringV1(const std::string &str) {
+    uint32_t result = 0;
+    size_t size = str.size();
+    auto data = reinterpret_cast<const uint8_t *>(str.data());
+
+    for (size_t i = 0; i + 4 <= size; i += 4) {
+        result ^= static_cast<uint32_t>(data[i]) | static_cast<uint32_t>(data[i + 1]) << 8 |
+                  static_cast<uint32_t>(data[i + 2]) << 16 | static_cast<uint32_t>(data[i + 3]) << 24;
+    }
+
+    size_t remainder = size & ~static_cast<size_t>(3);
+    if (size - remainder >= 2) {
+        result ^= static_cast<uint32_t>(data[remainder]) | static_cast<uint32_t>(data[remainder + 1]) << 8;
+        remainder += 2;
+    }
+
+    if (remainder < size) {
+        result ^= data[remainder];
+    }
+
+    result |= 0x20202020;
+    result ^= result >> 11;
+
+    return result ^ (result >> 16);
+}
+
+}
+}
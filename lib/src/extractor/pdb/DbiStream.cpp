@@ -0,0 +1,119 @@
+#include <algorithm>
+#include "extractor/pdb/CodeView.hpp"
+#include "extractor/pdb/DbiStream.hpp"
+
+namespace debugtocpp {
+namespace pdb {
+
+namespace {
+
+const uint32_t DBI_VERSION_V70 = 19990903;
+
+// Fixed part of module info, names follow it
+const uint32_t MODULE_INFO_SIZE = 64;
+const uint32_t MODULE_SYMBOL_STREAM_OFFSET = 34;
+
+// Index of section header stream in the optional debug header
+const uint32_t DEBUG_HEADER_SECTION_HEADERS = 5;
+
+const uint32_t SECTION_HEADER_SIZE = 40;
+const uint32_t SECTION_VIRTUAL_ADDRESS_OFFSET = 12;
+
+const uint16_t NIL_STREAM = 0xffff;
+
+}
+
+DbiStream::DbiStream(const MsfFile &msf) {
+    MsfStream stream = msf.getStream(STREAM_DBI);
+    if (stream.size() < sizeof(Header)) {
+        throw std::string("Missing PDB debug information stream");
+    }
+
+    std::vector<char> buffer;
+    memcpy(&header, stream.read(0, sizeof(Header), buffer), sizeof(Header));
+
+    if (header.versionSignature != -1 || header.version != DBI_VERSION_V70) {
+        throw std::string("Unsupported PDB debug information stream version " + std::to_string(header.version));
+    }
+
+    int32_t sizes[] = {header.moduleInfoSize, header.sectionContributionSize, header.sectionMapSize, header.sourceInfoSize,
+                       header.typeServerMapSize, header.ecSubstreamSize, header.optionalDebugHeaderSize};
+
+    uint64_t end = sizeof(Header);
+    for (int32_t size : sizes) {
+        if (size < 0) {
+            throw std::string("Invalid PDB debug information stream header");
+        }
+        end += static_cast<uint32_t>(size);
+    }
+
+    if (end > stream.size()) {
+        throw std::string("Invalid PDB debug information stream header");
+    }
+
+    readModules(stream, sizeof(Header));
+    readSectionHeaders(msf, stream, static_cast<uint32_t>(end - header.optionalDebugHeaderSize));
+}
+
+void DbiStream::readModules(const MsfStream &stream, uint32_t offset) {
+    std::vector<char> buffer;
+    RecordReader reader(stream.read(offset, static_cast<uint32_t>(header.moduleInfoSize), buffer),
+                        static_cast<size_t>(header.moduleInfoSize));
+
+    while (reader.remaining() >= MODULE_INFO_SIZE) {
+        const char *start = reader.position();
+
+        reader.skip(MODULE_SYMBOL_STREAM_OFFSET);
+        ModuleInfo module;
+        module.symbolStream = reader.u16();
+        module.symbolBytes = reader.u32();
+        reader.skip(MODULE_INFO_SIZE - MODULE_SYMBOL_STREAM_OFFSET - sizeof(uint16_t) - sizeof(uint32_t));
+
+        module.name = reader.string();
+        reader.string(); // Object file name
+
+        // Entries are aligned to 4 bytes
+        size_t size = static_cast<size_t>(reader.position() - start);
+        reader.skip(std::min(reader.remaining(), (4 - size % 4) % 4));
+
+        if (module.symbolStream == NIL_STREAM) {
+            module.symbolBytes = 0;
+        }
+
+        modules.push_back(module);
+    }
+}
+
+void DbiStream::readSectionHeaders(const MsfFile &msf, const MsfStream &stream, uint32_t offset) {
+    auto count = static_cast<uint32_t>(header.optionalDebugHeaderSize) / sizeof(uint16_t);
+    if (count <= DEBUG_HEADER_SECTION_HEADERS) {
+        return;
+    }
+
+    std::vector<char> buffer;
+    uint16_t index;
+    memcpy(&index, stream.read(offset + DEBUG_HEADER_SECTION_HEADERS * sizeof(uint16_t), sizeof(index), buffer), sizeof(index));
+
+    if (index == NIL_STREAM) {
+        return;
+    }
+
+    MsfStream sections = msf.getStream(index);
+    for (uint32_t position = 0; position + SECTION_HEADER_SIZE <= sections.size(); position += SECTION_HEADER_SIZE) {
+        uint32_t address;
+        memcpy(&address, sections.read(position + SECTION_VIRTUAL_ADDRESS_OFFSET, sizeof(address), buffer), sizeof(address));
+        sectionAddresses.push_back(address);
+    }
+}
+
+// Segments are numbered from 1
+int64_t DbiStream::getRelativeAddress(uint16_t segment, uint32_t offset) const {
+    if (segment == 0 || segment > sectionAddresses.size()) {
+        return -1;
+    }
+
+    return static_cast<int64_t>(sectionAddresses[segment - 1]) + offset;
+}
+
+}
+}
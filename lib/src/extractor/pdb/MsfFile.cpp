@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "extractor/pdb/MsfFile.hpp"
+
+namespace debugtocpp {
+namespace pdb {
+
+namespace {
+
+const char MSF_MAGIC[] = "Microsoft C/C++ MSF 7.00\r\n\x1a" "DS\0\0";
+const char MSF_MAGIC_OLD[] = "Microsoft C/C++ program database 2.00\r\n\x1a" "JG\0";
+
+const uint32_t NIL_STREAM_SIZE = 0xffffffff;
+
+struct SuperBlock {
+    char magic[sizeof(MSF_MAGIC)];
+    uint32_t blockSize;
+    uint32_t freeBlockMapBlock;
+    uint32_t blockCount;
+    uint32_t directorySize;
+    uint32_t unknown;
+    uint32_t blockMapAddress;
+};
+
+// Sizes near 4 GiB would wrap in 32 bits and look like empty streams
+uint64_t blocksFor(uint32_t size, uint32_t blockSize) {
+    return (static_cast<uint64_t>(size) + blockSize - 1) / blockSize;
+}
+
+}
+
+const char *MsfStream::read(uint32_t offset, uint32_t size, std::vector<char> &buffer) const {
+    if (static_cast<uint64_t>(offset) + size > streamSize) {
+        throw std::string("Read past the end of PDB stream");
+    }
+
+    uint32_t block = offset / blockSize;
+    uint32_t blockOffset = offset % blockSize;
+
+    if (blockOffset + size <= blockSize) {
+        return file + static_cast<uint64_t>(blocks[block]) * blockSize + blockOffset;
+    }
+
+    buffer.resize(size);
+    for (uint32_t copied = 0; copied < size; block++, blockOffset = 0) {
+        uint32_t count = std::min(blockSize - blockOffset, size - copied);
+        memcpy(&buffer[copied], file + static_cast<uint64_t>(blocks[block]) * blockSize + blockOffset, count);
+        copied += count;
+    }
+
+    return buffer.data();
+}
+
+MsfFile::~MsfFile() {
+    if (file != nullptr) {
+        munmap(const_cast<char *>(file), fileSize);
+    }
+}
+
+ExtractResult MsfFile::open(const std::string &filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return ExtractResult::ERR_FILE_OPEN;
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SuperBlock)) {
+        ::close(fd);
+        return ExtractResult::INVALID_FILE;
+    }
+
+    fileSize = static_cast<size_t>(info.st_size);
+    void *mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (mapping == MAP_FAILED) {
+        return ExtractResult::ERR_FILE_OPEN;
+    }
+    file = static_cast<const char *>(mapping);
+
+    SuperBlock superBlock{};
+    memcpy(&superBlock, file, sizeof(superBlock));
+
+    if (memcmp(superBlock.magic, MSF_MAGIC, sizeof(MSF_MAGIC)) != 0) {
+        bool old = memcmp(superBlock.magic, MSF_MAGIC_OLD, sizeof(superBlock.magic)) == 0;
+        return old ? ExtractResult::UNSUPPORTED_VERSION : ExtractResult::INVALID_FILE;
+    }
+
+    blockSize = superBlock.blockSize;
+    if (blockSize < 512 || blockSize > 65536 || (blockSize & (blockSize - 1)) != 0) {
+        return ExtractResult::INVALID_FILE;
+    }
+
+    // Every block referenced later is checked against this, so that reads never leave the mapping
+    auto blockCount = static_cast<uint32_t>(std::min<uint64_t>(superBlock.blockCount, fileSize / blockSize));
+
+    // Block map lists blocks of the stream directory
+    uint64_t directoryBlockCount = blocksFor(superBlock.directorySize, blockSize);
+    if (superBlock.blockMapAddress >= blockCount || superBlock.directorySize < sizeof(uint32_t) ||
+        directoryBlockCount * sizeof(uint32_t) > blockSize) {
+        return ExtractResult::INVALID_FILE;
+    }
+
+    auto directoryBlocks = reinterpret_cast<const uint32_t *>(file + static_cast<uint64_t>(superBlock.blockMapAddress) * blockSize);
+    for (uint64_t i = 0; i < directoryBlockCount; i++) {
+        if (directoryBlocks[i] >= blockCount) {
+            return ExtractResult::INVALID_FILE;
+        }
+    }
+
+    // Directory is the only thing copied, streams refer to their block lists in it
+    MsfStream directoryStream(file, blockSize, superBlock.directorySize, directoryBlocks);
+    std::vector<char> buffer;
+    const char *data = directoryStream.read(0, superBlock.directorySize, buffer);
+    directory.assign(data, data + superBlock.directorySize);
+
+    auto words = reinterpret_cast<const uint32_t *>(directory.data());
+    size_t wordCount = directory.size() / sizeof(uint32_t);
+
+    if (wordCount == 0 || words[0] > wordCount - 1) {
+        return ExtractResult::INVALID_FILE;
+    }
+
+    uint32_t streamCount = words[0];
+    size_t next = 1 + streamCount;
+
+    streamSizes.assign(words + 1, words + 1 + streamCount);
+    streamBlocks.resize(streamCount);
+
+    for (uint32_t i = 0; i < streamCount; i++) {
+        if (streamSizes[i] == NIL_STREAM_SIZE) {
+            streamSizes[i] = 0;
+        }
+
+        uint64_t count = blocksFor(streamSizes[i], blockSize);
+        if (count > wordCount - next) {
+            return ExtractResult::INVALID_FILE;
+        }
+
+        for (uint64_t j = 0; j < count; j++) {
+            if (words[next + j] >= blockCount) {
+                return ExtractResult::INVALID_FILE;
+            }
+        }
+
+        streamBlocks[i] = words + next;
+        next += count;
+    }
+
+    return ExtractResult::OK;
+}
+
+MsfStream MsfFile::getStream(uint32_t index) const {
+    if (index >= streamSizes.size()) {
+        return MsfStream();
+    }
+
+    return MsfStream(file, blockSize, streamSizes[index], streamBlocks[index]);
+}
+
+}
+}
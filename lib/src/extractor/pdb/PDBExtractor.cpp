@@ -1,138 +1,270 @@
+#include <algorithm>
 #include <cstring>
 #include <list>
+#include <set>
 #include "extractor/pdb/PDBExtractor.hpp"
 #include "utils/utils.hpp"
 
 namespace debugtocpp {
 namespace pdb {
 
+// Only the stream directory is read here, streams are parsed when a query needs them
 ExtractResult PDBExtractor::load(std::string filename, int image_base) {
-    pdb = PDBFile();
-
-    switch (pdb.load_pdb_file(filename.c_str())) {
-        case PDB_STATE_ERR_FILE_OPEN:
-            return ExtractResult::ERR_FILE_OPEN;
-        case PDB_STATE_INVALID_FILE:
-            return ExtractResult::INVALID_FILE;
-        case PDB_STATE_UNSUPPORTED_VERSION:
-            return ExtractResult::UNSUPPORTED_VERSION;
-        case PDB_STATE_ALREADY_LOADED:break;
-        case PDB_STATE_OK:
-            pdb.initialize(image_base);
-            return ExtractResult::OK;
-    }
-
-    return ExtractResult::UNKNOWN_ERROR;
+    imageBase = image_base;
+
+    return msf.open(filename);
+}
+
+TpiStream &PDBExtractor::getTpi() {
+    if (tpi == nullptr) {
+        tpi = new TpiStream(msf, STREAM_TPI);
+    }
+
+    return *tpi;
+}
+
+// Function ids of S_GPROC32_ID and S_LPROC32_ID symbols
+TpiStream &PDBExtractor::getIpi() {
+    if (ipi == nullptr) {
+        ipi = new TpiStream(msf, STREAM_IPI);
+    }
+
+    return *ipi;
+}
+
+DbiStream &PDBExtractor::getDbi() {
+    if (dbi == nullptr) {
+        dbi = new DbiStream(msf);
+    }
+
+    return *dbi;
+}
+
+// Functions and global variables, all modules are parsed on the first use
+SymbolTable &PDBExtractor::getSymbols() {
+    if (symbols == nullptr) {
+        symbols = new SymbolTable(msf, getDbi(), static_cast<unsigned int>(imageBase));
+    }
+
+    return *symbols;
+}
+
+PublicSymbolTable &PDBExtractor::getPublicSymbols() {
+    if (publicSymbols == nullptr) {
+        publicSymbols = new PublicSymbolTable(msf, getDbi(), static_cast<unsigned int>(imageBase));
+    }
+
+    return *publicSymbols;
 }
 
 Type *PDBExtractor::getType(std::string name) {
     allDependentClasses.clear();
 
-    auto * pdbType = new PDBUniversalType(findFullDeclaration(name));
-
-    // Type = class or struct
-    if (!pdbType->isType()) {
+    auto listed = listedTypes.find(name);
+    uint32_t index = listed != listedTypes.end() ? listed->second : getTpi().findType(name);
+    if (index == 0) {
         return nullptr;
     }
 
-    Type * type = new Type(pdbType->getName());
-    PDBTypeFieldList * fieldsList = reinterpret_cast<PDBTypeFieldList *>(pdb.get_types_container()->types[pdbType->getFieldListTypeId()]);
+    return loadType(index);
+}
 
-    // Load all fields (methods of class are also fields)
-    if (fieldsList != nullptr) {
-        for (auto &pdbField : fieldsList->fields) {
+// One pass over functions and global variables groups them by the class they belong to
+void PDBExtractor::indexSymbols() {
+    if (symbolsIndexed) {
+        return;
+    }
 
-            // Load base classes/structs
-            if (pdbField.field_type == PDBFIELD_BASE) {
-                auto pdbBaseType = new PDBUniversalType(pdbField.Member.type_def);
-                type->baseTypes.push_back(new Type(pdbBaseType->getName()));
-                delete(pdbBaseType);
+    symbolsIndexed = true;
+
+    for (auto &function : getSymbols().getFunctions()) {
+        std::vector<char> buffer;
+        uint16_t kind;
+        uint32_t parentType;
+        ClassFunction method{&function, function.type, ""};
+
+        if (function.isFunctionId) {
+            RecordReader reader = getIpi().getRecord(function.type, kind, buffer);
+            if (kind != LF_MFUNC_ID) {
                 continue;
             }
 
-            // Load methods TODO METHOD
-            if (pdbField.field_type == PDBFIELD_ONEMETHOD) {
-                type->allMethods.push_back(getMethod(&pdbField.Member));
+            FunctionIdRecord id = readFunctionId(kind, reader);
+            parentType = id.parentType;
+            method.type = id.type;
+            method.name = id.name;
+        } else if (function.type >= FIRST_TYPE_INDEX) {
+            RecordReader reader = getTpi().getRecord(function.type, kind, buffer);
+            if (kind != LF_MFUNCTION) {
                 continue;
             }
 
-            if (pdbField.field_type == PDBFIELD_NESTTYPE) {
-                Type * nestedType = getType(type->name + "::" + pdbField.Member.name);
+            parentType = readProcedure(kind, reader).classType;
+        } else {
+            continue;
+        }
+
+        const CachedTypePtr &parentClass = getCachedTypePtr(parentType);
+        if (!parentClass.isClass) {
+            continue;
+        }
+
+        // Names of symbols are qualified by the class
+        if (method.name.empty()) {
+            std::string prefix = parentClass.typePtr.type + "::";
+            bool qualified = function.name.compare(0, prefix.size(), prefix) == 0;
+            method.name = qualified ? function.name.substr(prefix.size()) : function.name;
+        }
+
+        classFunctions[parentClass.typePtr.type].push_back(method);
+    }
+
+    for (auto &globalVar : getSymbols().getGlobalVariables()) {
+        globalVariablesByName[globalVar.name] = &globalVar;
+    }
+}
+
+// Types are extracted once and shared by direct requests and enclosing types
+Type *PDBExtractor::loadType(uint32_t index) {
+    auto cached = typeCache.find(index);
+    if (cached != typeCache.end()) {
+        if (cached->second != nullptr) {
+            allDependentClasses.insert(allDependentClasses.end(), cached->second->dependentTypes.begin(), cached->second->dependentTypes.end());
+        }
+
+        return cached->second;
+    }
+
+    // Dependencies of the type are collected separately and added to the enclosing type afterwards
+    std::list<std::string> outerDependentClasses;
+    outerDependentClasses.swap(allDependentClasses);
+
+    // Placeholder stops types nested in each other from recursing forever
+    typeCache[index] = nullptr;
+    Type *type = extractType(index);
+    typeCache[index] = type;
+
+    allDependentClasses.swap(outerDependentClasses);
+    if (type != nullptr) {
+        allDependentClasses.insert(allDependentClasses.end(), type->dependentTypes.begin(), type->dependentTypes.end());
+    }
+
+    return type;
+}
+
+// Type = class or struct
+Type *PDBExtractor::extractType(uint32_t index) {
+    std::vector<char> buffer;
+    uint16_t kind;
+    RecordReader reader = getTpi().getRecord(index, kind, buffer);
+
+    if (kind != LF_CLASS && kind != LF_STRUCTURE) {
+        return nullptr;
+    }
+
+    UdtRecord udt = readUdt(kind, reader);
+    Type * type = new Type(udt.name);
+
+    // Declarations by name and type index, overloads differ in the type
+    std::map<std::pair<std::string, uint32_t>, Method *> declaredMethods;
+
+    // Load all fields (methods of class are also fields)
+    getTpi().forEachMember(udt.fieldList, [&](const MemberRecord &member) {
+        switch (member.kind) {
+            // Load base classes/structs
+            case LF_BCLASS: {
+                std::vector<char> baseBuffer;
+                uint16_t baseKind;
+                RecordReader baseReader = getTpi().getRecord(member.type, baseKind, baseBuffer);
+
+                if (baseKind == LF_CLASS || baseKind == LF_STRUCTURE) {
+                    type->baseTypes.push_back(new Type(readUdt(baseKind, baseReader).name));
+                }
+                break;
+            }
+
+            case LF_ONEMETHOD: {
+                Method * method = getMethod(member);
+                declaredMethods[std::make_pair(member.name, member.type)] = method;
+                type->allMethods.push_back(method);
+                break;
+            }
+
+            // Overloaded methods
+            case LF_METHOD: {
+                std::vector<char> listBuffer;
+                uint16_t listKind;
+                RecordReader listReader = getTpi().getRecord(member.type, listKind, listBuffer);
+
+                while (listKind == LF_METHODLIST && listReader.remaining() > 0) {
+                    MemberRecord overload = readMethodListEntry(listReader);
+                    overload.name = member.name;
+
+                    Method * method = getMethod(overload);
+                    declaredMethods[std::make_pair(overload.name, overload.type)] = method;
+                    type->allMethods.push_back(method);
+                }
+                break;
+            }
+
+            case LF_NESTTYPE: {
+                Type * nestedType = loadType(getTpi().resolveForwardReference(member.type));
                 if (nestedType != nullptr) {
-                    nestedType->name = pdbField.Member.name;
-//                    type->nestedTypes.push_back(nestedType);
+                    // Shallow copy, so that the shared type keeps its qualified name
+                    nestedType = new Type(*nestedType);
+                    nestedType->name = member.name;
                 } else {
-                    nestedType = new Type(pdbField.Member.name);
-//                    type->nestedTypes.push_back(nestedType);
+                    nestedType = new Type(member.name);
                 }
                 type->nestedTypes.push_back(nestedType);
-                continue;
+                break;
             }
 
             // Load fields
-            Field * field = new Field(pdbField.Member.name, getReturnType(pdbField.Member.type_def), pdbField.Member.offset);
-            field->accessibility = Accessibility::PUBLIC;
-
-            if (pdbField.field_type == PDBFIELD_STMEMBER) {
-                field->isStatic = true;
+            case LF_MEMBER:
+            case LF_STMEMBER: {
+                Field * field = new Field(member.name, getTypePtr(member.type), static_cast<int>(member.offset));
+                field->accessibility = Accessibility::PUBLIC;
+                field->isStatic = member.kind == LF_STMEMBER;
+
+                type->fields.push_back(field);
+                break;
             }
 
-            type->fields.push_back(field);
-
+            default:
+                break;
         }
+    });
 
-        // Search global variables for addresses
-        for (auto &globalVar : *pdb.get_global_variables()) {
-            for (auto &field : type->fields) {
-                if (globalVar.second.name == name + "::" + field->name) {
-                    field->address = (unsigned long) globalVar.second.address;
-                }
-            }
+    indexSymbols();
+
+    // Search global variables for addresses
+    for (auto &field : type->fields) {
+        auto globalVar = globalVariablesByName.find(type->name + "::" + field->name);
+        if (globalVar != globalVariablesByName.end()) {
+            field->address = (unsigned long) globalVar->second->address;
         }
     }
 
-    // Load all methods
-    for (auto &func : *pdb.get_functions()) {
-        // ??
-        if (dynamic_cast<PDBTypeClass *>(func.second->type_def->func_clstype_def)) {
-            auto parentClass = (PDBTypeClass *) func.second->type_def->func_clstype_def;
-
-            if (strcmp(parentClass->class_name, type->name.c_str()) == 0) {
-                Method *method = getMethod(func.second);
-
-                bool found = false;
-                // Apply more details to already found methods
-                for (int i = 0; i < type->allMethods.size(); i++) {
-                    if (type->allMethods[i]->name == method->name.substr(type->name.size() + 2)) {
-                        int offset = (!method->args.empty() && method->args[0]->name == "this" ? 1 : 0);
-                        if (method->args.size() - offset != type->allMethods[i]->args.size()) {
-                            continue;
-                        }
-
-                        for (int j = offset; j < method->args.size(); j++) {
-                            if (*method->args[j]->typePtr != *type->allMethods[i]->args[j - offset]->typePtr) {
-                                goto continue_loop;
-                            }
-                        }
-
-                        type->allMethods[i]->args = method->args;
-                        type->allMethods[i]->address = method->address;
-                        type->allMethods[i]->isStatic = method->isStatic;
-
-                        found = true;
-                        break;
-                    }
-                    continue_loop: continue;
-                }
-
-                if (!found) {
-                    method->name = method->name.substr(type->name.size() + 2);
-                    type->allMethods.push_back(method);
-                }
+    // Load all methods, definitions have the same type index as their declarations
+    for (auto &function : classFunctions[type->name]) {
+        Method *method = getMethod(*function.symbol, function.type);
+        if (method == nullptr) {
+            continue;
+        }
 
-                type->fullyDefinedMethods.push_back(method);
-            }
+        auto declaration = declaredMethods.find(std::make_pair(function.name, function.type));
+        if (declaration != declaredMethods.end()) {
+            // Apply more details to already found methods
+            declaration->second->args = method->args;
+            declaration->second->address = method->address;
+            declaration->second->isStatic = method->isStatic;
+        } else {
+            method->name = function.name;
+            type->allMethods.push_back(method);
         }
+
+        type->fullyDefinedMethods.push_back(method);
     }
 
     if (!type->baseTypes.empty()) {
@@ -143,130 +275,183 @@ Type *PDBExtractor::getType(std::string name) {
     allDependentClasses.unique();
     type->dependentTypes = allDependentClasses;
 
-    delete(pdbType);
     return type;
 }
 
-Method *PDBExtractor::getMethod(PDBFunction *func) {
-    auto * method = new Method();
+// Type is the LF_MFUNCTION of the symbol or of its function id, other types give nullptr
+Method *PDBExtractor::getMethod(const FunctionSymbol &function, uint32_t functionType) {
+    if (functionType < FIRST_TYPE_INDEX) {
+        return nullptr;
+    }
 
-    method->name = func->name;
-    if (method->name[0] == '~') { // Fixes destructor returning void
-        method->returnType = new TypePtr("", false);
-    } else {
-        method->returnType = getReturnType(func->type_def->func_rettype_def);
+    std::vector<char> buffer;
+    uint16_t kind;
+    RecordReader reader = getTpi().getRecord(functionType, kind, buffer);
+
+    if (kind != LF_MFUNCTION) {
+        return nullptr;
     }
 
-    method->address = func->address;
-    method->callType = func->type_def->func_calltype;
-    method->isStatic = func->type_def->func_thistype_index == 0;
-    method->isVariadic = func->type_def->func_is_variadic;
-    method->accessibility = Accessibility::PUBLIC;
+    ProcedureRecord procedure = readProcedure(kind, reader);
+    Method *method = getMethod(function.name, procedure);
+    method->address = function.address;
 
-    std::vector<Argument *> args;
-    for (auto &fArg : func->arguments) {
-        PDBTypeDef *argumentType = pdb.get_types_container()->get_type_by_index(fArg.type_index);
+    // Symbols have names of the arguments, this pointer is the first one
+    if (!method->isStatic) {
+        method->args.insert(method->args.begin(), new Argument("this", getTypePtr(procedure.thisType)));
+    }
 
-        Argument *arg = new Argument(fArg.name, getReturnType(argumentType));
-        args.push_back(arg);
+    for (size_t i = 0; i < method->args.size() && i < function.arguments.size(); i++) {
+        method->args[i]->name = function.arguments[i].name;
     }
-    method->args = args;
 
     return method;
 }
 
-Method *PDBExtractor::getMethod(PDBTypeFieldMember *fieldMember) {
-    auto * pdbTypeFunction = (PDBTypeFunction *) fieldMember->type_def;
+Method *PDBExtractor::getMethod(const MemberRecord &member) {
+    std::vector<char> buffer;
+    uint16_t kind;
+    RecordReader reader = getTpi().getRecord(member.type, kind, buffer);
+
+    Method *method = getMethod(member.name, readProcedure(kind, reader));
+    uint16_t property = member.getMethodProperty();
+
+    method->isVirtual = property == METHOD_VIRTUAL || property == METHOD_INTRO_VIRTUAL ||
+                        property == METHOD_PURE_VIRTUAL || property == METHOD_PURE_INTRO_VIRTUAL;
+    method->vftableOffset = member.vftableOffset;
+
+    return method;
+}
+
+Method *PDBExtractor::getMethod(const std::string &name, const ProcedureRecord &procedure) {
     auto * method = new Method();
 
-    method->name = fieldMember->name;
+    method->name = name;
     if (method->name[0] == '~') { // Fixes destructor returning void
         method->returnType = new TypePtr("", false);
     } else {
-        method->returnType = getReturnType(pdbTypeFunction->func_rettype_def);
+        method->returnType = getTypePtr(procedure.returnType);
     }
 
-    method->callType = pdbTypeFunction->func_calltype;
-    method->isStatic = pdbTypeFunction->func_thistype_index == 0;
-    method->isVariadic = pdbTypeFunction->func_is_variadic;
-    method->isVirtual = fieldMember->offset != -1;
-    method->vftableOffset = fieldMember->offset;
+    method->callType = procedure.callingConvention;
+    method->isStatic = procedure.thisType == 0;
     method->accessibility = Accessibility::PUBLIC;
 
-    for (int i = 0; i < pdbTypeFunction->func_args_count; i++) {
-        Argument * arg = new Argument("", getReturnType(pdbTypeFunction->func_args[i].type_def));
-        method->args.push_back(arg);
+    std::vector<char> buffer;
+    uint16_t kind;
+    RecordReader arguments = getTpi().getRecord(procedure.argumentList, kind, buffer);
+    uint32_t count = arguments.u32();
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t argumentType = arguments.u32();
+
+        // Variadic functions end with no type
+        if (argumentType == 0 && i == count - 1) {
+            method->isVariadic = true;
+            break;
+        }
+
+        method->args.push_back(new Argument("", getTypePtr(argumentType)));
     }
 
     return method;
 }
 
-TypePtr * PDBExtractor::getReturnType(PDBTypeDef *type, int flags) {
-    if (dynamic_cast<PDBTypeBase *>(type)) {
-        auto * typeBase = (PDBTypeBase *) type;
-        TypePtr *typePtr = new TypePtr(typeBase->description, false);
-        typePtr->isBaseType = true;
+// Callers modify returned descriptions, so every caller gets its own copy
+TypePtr * PDBExtractor::getTypePtr(uint32_t index) {
+    const CachedTypePtr &cached = getCachedTypePtr(index);
+    if (cached.isClass) {
+        allDependentClasses.push_back(cached.typePtr.type);
+    }
 
-        if (flags & 1) typePtr->isConstant = true;
-        if (flags & 2) typePtr->isPointer = true;
+    return new TypePtr(cached.typePtr);
+}
 
-        return typePtr;
-    } else if (dynamic_cast<PDBTypeConst *>(type)) {
-        return getReturnType(((PDBTypeConst *) type)->const_utype_def, flags | 1);
-    } else if (dynamic_cast<PDBTypePointer *>(type)) {
-        return getReturnType(((PDBTypePointer *) type)->ptr_utype_def, flags | 2); // Follows pointer to the type
+// Same types are referenced by many members and arguments, every type record is resolved only once
+const PDBExtractor::CachedTypePtr &PDBExtractor::getCachedTypePtr(uint32_t index) {
+    // Sized once, so that references stay valid while modifiers resolve the types they wrap.
+    // Simple types below FIRST_TYPE_INDEX are cached too
+    if (typePtrCache.empty()) {
+        typePtrCache.resize(getTpi().getEndIndex());
     }
 
-    auto pdbType = new PDBUniversalType(type);
-    if (!pdbType->isType()) {
-        delete(pdbType);
-        return new TypePtr("int", false);
+    if (index >= typePtrCache.size()) {
+        throw std::string("Type index " + std::to_string(index) + " is out of PDB type stream");
     }
 
-    std::string name = pdbType->getName();
-    allDependentClasses.push_back(name);
+    CachedTypePtr &cached = typePtrCache[index];
+    if (!cached.resolved) {
+        cached = resolveTypePtr(index);
+        cached.resolved = true;
+    }
 
-    delete(pdbType);
-    auto * typePtr = new TypePtr(name, true);
+    return cached;
+}
 
-    if (flags & 1) typePtr->isConstant = true;
-    if (flags & 2) typePtr->isPointer = true;
+PDBExtractor::CachedTypePtr PDBExtractor::resolveTypePtr(uint32_t index) {
+    CachedTypePtr cached;
 
-    return typePtr;
-}
+    if (index < FIRST_TYPE_INDEX) {
+        cached.typePtr = TypePtr(getSimpleTypeName(index), isSimpleTypePointer(index));
+        cached.typePtr.isBaseType = true;
 
-PDBTypeDef *PDBExtractor::findFullDeclaration(std::string name) {
-    PDBTypeDef * last = nullptr;
+        return cached;
+    }
 
-    for (auto &type : pdb.get_types_container()->types_fully_defined) {
-        auto pdbType = new PDBUniversalType(type.second);
-        if (pdbType->isType()) {
-            if (pdbType->getName() != name) {
-                delete(pdbType);
-                continue;
-            }
+    std::vector<char> buffer;
+    uint16_t kind;
+    RecordReader reader = getTpi().getRecord(index, kind, buffer);
 
-            last = type.second;
+    switch (kind) {
+        case LF_MODIFIER: {
+            uint32_t modifiedType = reader.u32();
+            uint16_t modifiers = reader.u16();
+
+            cached = getCachedTypePtr(modifiedType);
+            if (modifiers & MODIFIER_CONST) cached.typePtr.isConstant = true;
+            break;
         }
-        delete(pdbType);
+
+        case LF_POINTER:
+            cached = getCachedTypePtr(reader.u32()); // Follows pointer to the type
+            cached.typePtr.isPointer = true;
+            break;
+
+        case LF_CLASS:
+        case LF_STRUCTURE:
+            cached.typePtr = TypePtr(readUdt(kind, reader).name, true);
+            cached.isClass = true;
+            break;
+
+        default:
+            cached.typePtr = TypePtr("int", false);
+            break;
     }
 
-    return last;
+    return cached;
 }
 
+// Listing reads only the TPI stream, the indices it passes are kept for getTypes
 std::list<std::string> PDBExtractor::getTypesList(bool showStructs) {
     std::list<std::string> names;
 
-    for (auto &type : pdb.get_types_container()->types_fully_defined) {
-        auto pdbType = new PDBUniversalType(type.second);
-        if (!pdbType->isType() || (pdbType->getPDBType() == PDBTYPE_STRUCT && !showStructs)) {
-            delete(pdbType);
-            continue;
+    getTpi().forEachRecord([&](uint32_t index, uint16_t kind, RecordReader reader) {
+        if (kind != LF_CLASS && kind != LF_STRUCTURE) {
+            return;
         }
 
-        names.emplace_back(pdbType->getName());
-        delete(pdbType);
-    }
+        UdtRecord udt = readUdt(kind, reader);
+        if (udt.isForwardReference()) {
+            return;
+        }
+
+        listedTypes.emplace(udt.name, index);
+        if (kind == LF_STRUCTURE && !showStructs) {
+            return;
+        }
+
+        names.emplace_back(udt.name);
+    });
 
     names.sort();
     names.unique();
@@ -274,9 +459,9 @@ std::list<std::string> PDBExtractor::getTypesList(bool showStructs) {
     return names;
 }
 
+// Symbol tables are indexed once for all types, every type then reads only its own records
 std::vector<Type *> PDBExtractor::getTypes(std::list<std::string> typesList) {
     std::vector<Type *> types;
-    // No optimization here yet
     for (std::string &name : typesList) {
         types.push_back(getType(name));
     }
@@ -287,12 +472,12 @@ std::vector<Type *> PDBExtractor::getTypes(std::list<std::string> typesList) {
 std::vector<Field *> PDBExtractor::getAllGlobalVariables() {
     std::vector<Field *> fields;
 
-    for (auto &var : *pdb.get_global_variables()) {
+    for (auto &var : getSymbols().getGlobalVariables()) {
         auto * field = new Field();
-        field->name = var.second.name;
-        field->address = var.second.address;
+        field->name = var.name;
+        field->address = var.address;
         field->accessibility = Accessibility::PUBLIC;
-        field->typePtr = getReturnType(var.second.type_def);
+        field->typePtr = getTypePtr(var.type);
 
         fields.push_back(field);
     }
@@ -300,50 +485,101 @@ std::vector<Field *> PDBExtractor::getAllGlobalVariables() {
     return fields;
 }
 
-// PDBUniversalType methods
+// Procedure lengths come from module symbols, sizes of global variables from their types
+std::vector<AddressRange> PDBExtractor::getAddressRanges() {
+    std::vector<AddressRange> ranges;
+
+    for (auto &function : getSymbols().getFunctions()) {
+        AddressRange range;
+        range.start = function.address;
+        range.size = function.length;
+        range.name = function.name;
+        range.isFunction = true;
 
-std::string PDBUniversalType::getName() {
-    if (pdbClass != nullptr) {
-        return pdbClass->class_name;
-    } else if (pdbStruct != nullptr) {
-        return pdbStruct->struct_name;
+        ranges.push_back(range);
     }
 
-    return std::__cxx11::string();
-}
+    for (auto &variable : getSymbols().getGlobalVariables()) {
+        AddressRange range;
+        range.start = variable.address;
+        range.size = getTypeSize(variable.type);
+        range.name = variable.name;
 
-PDBUniversalType::PDBUniversalType(PDBTypeDef * typeDef) {
-    if (dynamic_cast<PDBTypeClass *>(typeDef)) {
-        pdbClass = (PDBTypeClass *) typeDef;
+        ranges.push_back(range);
     }
-    else if (dynamic_cast<PDBTypeStruct *>(typeDef)) {
-        pdbStruct = (PDBTypeStruct *) typeDef;
+
+    // Public symbols cover what module symbols don't, e.g. when the PDB was stripped of them. They have no size,
+    // functions are taken to reach the next known symbol of their section
+    std::set<uint64_t> starts;
+    for (auto &range : ranges) {
+        starts.insert(range.start);
     }
+
+    bool extendLast = false;
+    uint16_t lastSegment = 0;
+
+    getPublicSymbols().forEachSymbol([&](const PublicSymbol &symbol) {
+        if (extendLast && symbol.address > ranges.back().start) {
+            if (lastSegment == symbol.segment) {
+                auto next = starts.upper_bound(ranges.back().start);
+                uint64_t end = next != starts.end() ? std::min(symbol.address, *next) : symbol.address;
+                ranges.back().size = end - ranges.back().start;
+            }
+            extendLast = false;
+        }
+
+        // Aliases of an address are added once
+        if (!starts.insert(symbol.address).second) {
+            return;
+        }
+
+        AddressRange range;
+        range.start = symbol.address;
+        range.name = symbol.name;
+        range.isFunction = symbol.isFunction;
+
+        ranges.push_back(range);
+        extendLast = range.isFunction;
+        lastSegment = symbol.segment;
+    });
+
+    return ranges;
 }
 
-int PDBUniversalType::getFieldListTypeId() {
-    if (pdbClass != nullptr) {
-        return pdbClass->field;
-    } else if (pdbStruct != nullptr) {
-        return pdbStruct->field;
+uint64_t PDBExtractor::getTypeSize(uint32_t index) {
+    if (index < FIRST_TYPE_INDEX) {
+        return getSimpleTypeSize(index);
     }
 
-    return -1;
-}
+    std::vector<char> buffer;
+    uint16_t kind;
+    RecordReader reader = getTpi().getRecord(index, kind, buffer);
+
+    switch (kind) {
+        case LF_MODIFIER:
+            return getTypeSize(reader.u32());
+        case LF_POINTER:
+            reader.u32(); // Pointee
+            return (reader.u32() >> 13) & 0x3f; // Size bits of attributes
+        case LF_ARRAY:
+            reader.skip(2 * sizeof(uint32_t)); // Element and index types
+            return static_cast<uint64_t>(reader.numeric());
+        default:
+            break;
+    }
 
-ePDBTypeClass PDBUniversalType::getPDBType() {
-    if (pdbClass != nullptr) {
-        return pdbClass->type_class;
-    } else if (pdbStruct != nullptr) {
-        return pdbStruct->type_class;
+    if (!isUdt(kind)) {
+        return 0;
     }
 
-    return PDBTYPE_CONST;
-}
+    UdtRecord udt = readUdt(kind, reader);
+    if (udt.isForwardReference()) {
+        uint32_t definition = getTpi().resolveForwardReference(index);
+        return definition != index ? getTypeSize(definition) : 0;
+    }
 
-bool PDBUniversalType::isType() {
-    return getPDBType() == PDBTYPE_CLASS || getPDBType() == PDBTYPE_STRUCT;
-}
+    return kind == LF_ENUM ? getTypeSize(udt.underlyingType) : udt.size;
 }
 
 }
+}
@@ -0,0 +1,215 @@
+#include <algorithm>
+#include "extractor/pdb/CodeView.hpp"
+#include "extractor/pdb/PublicSymbolTable.hpp"
+
+namespace debugtocpp {
+namespace pdb {
+
+namespace {
+
+const uint32_t PUBLIC_CODE = 0x1;
+const uint32_t PUBLIC_FUNCTION = 0x2;
+
+const uint32_t GSI_HASH_SIGNATURE = 0xffffffff;
+const uint32_t GSI_HASH_VERSION = 0xeffe0000 + 19990810;
+
+const uint32_t IPHR_HASH = 4096;
+const uint32_t HASH_BITMAP_WORDS = (IPHR_HASH + 32) / 32;
+
+// Records in the file are offset + 1 and reference count, bucket values count them in 12 byte units
+const uint32_t HASH_RECORD_SIZE = 8;
+const uint32_t HASH_BUCKET_UNIT = 12;
+
+struct HashHeader {
+    uint32_t signature;
+    uint32_t version;
+    uint32_t recordsSize;
+    uint32_t bucketsSize;
+};
+
+}
+
+PublicSymbolTable::PublicSymbolTable(const MsfFile &msf, const DbiStream &dbi, uint64_t imageBase)
+        : dbi(dbi), records(msf.getStream(dbi.getSymbolRecordStream())), imageBase(imageBase) {
+    MsfStream stream = msf.getStream(dbi.getPublicSymbolStream());
+    if (stream.size() < sizeof(Header)) {
+        return;
+    }
+
+    std::vector<char> buffer;
+    Header header{};
+    memcpy(&header, stream.read(0, sizeof(Header), buffer), sizeof(Header));
+
+    if (sizeof(Header) + static_cast<uint64_t>(header.symbolHashSize) + header.addressMapSize > stream.size()) {
+        throw std::string("Invalid PDB public symbol stream header");
+    }
+
+    loadHash(stream, sizeof(Header), header.symbolHashSize);
+    loadAddressMap(stream, sizeof(Header) + header.symbolHashSize, header.addressMapSize);
+}
+
+void PublicSymbolTable::loadHash(const MsfStream &stream, uint32_t offset, uint32_t size) {
+    if (size < sizeof(HashHeader)) {
+        return;
+    }
+
+    std::vector<char> buffer;
+    HashHeader header{};
+    memcpy(&header, stream.read(offset, sizeof(HashHeader), buffer), sizeof(HashHeader));
+
+    uint32_t bitmapSize = HASH_BITMAP_WORDS * sizeof(uint32_t);
+    if (header.signature != GSI_HASH_SIGNATURE || header.version != GSI_HASH_VERSION || header.bucketsSize < bitmapSize ||
+        sizeof(HashHeader) + static_cast<uint64_t>(header.recordsSize) + header.bucketsSize > size) {
+        return;
+    }
+
+    RecordReader reader(stream.read(offset + sizeof(HashHeader), header.recordsSize + header.bucketsSize, buffer),
+                        header.recordsSize + header.bucketsSize);
+
+    uint32_t recordCount = header.recordsSize / HASH_RECORD_SIZE;
+    for (uint32_t i = 0; i < recordCount; i++) {
+        hashRecords.push_back(reader.u32() - 1);
+        reader.u32();
+    }
+    reader.skip(header.recordsSize % HASH_RECORD_SIZE);
+
+    // Only buckets set in the bitmap are stored, empty buckets start where the next one does
+    uint32_t bitmap[HASH_BITMAP_WORDS];
+    for (uint32_t &word : bitmap) {
+        word = reader.u32();
+    }
+
+    bucketStarts.assign(IPHR_HASH + 1, recordCount);
+    std::vector<bool> present(IPHR_HASH);
+
+    for (uint32_t i = 0; i < IPHR_HASH; i++) {
+        if (bitmap[i / 32] & (1u << (i % 32))) {
+            if (reader.remaining() < sizeof(uint32_t)) {
+                break;
+            }
+
+            bucketStarts[i] = reader.u32() / HASH_BUCKET_UNIT;
+            present[i] = true;
+        }
+    }
+
+    for (uint32_t i = IPHR_HASH; i-- > 0;) {
+        if (!present[i]) {
+            bucketStarts[i] = bucketStarts[i + 1];
+        }
+    }
+
+    // A malformed table is not used, lookups by name then walk the address map
+    if (!std::is_sorted(bucketStarts.begin(), bucketStarts.end())) {
+        bucketStarts.clear();
+        hashRecords.clear();
+    }
+}
+
+void PublicSymbolTable::loadAddressMap(const MsfStream &stream, uint32_t offset, uint32_t size) {
+    std::vector<char> buffer;
+    RecordReader reader(stream.read(offset, size, buffer), size);
+
+    entries.reserve(size / sizeof(uint32_t));
+    while (reader.remaining() >= sizeof(uint32_t)) {
+        uint32_t record = reader.u32();
+
+        PublicSymbol symbol;
+        if (readSymbol(record, symbol, false)) {
+            entries.push_back({symbol.address, record});
+        }
+    }
+
+    // The map is ordered by section and offset, which follows addresses unless sections are out of order
+    auto byAddress = [](const Entry &a, const Entry &b) { return a.address < b.address; };
+    if (!std::is_sorted(entries.begin(), entries.end(), byAddress)) {
+        std::stable_sort(entries.begin(), entries.end(), byAddress);
+    }
+}
+
+bool PublicSymbolTable::readSymbol(uint32_t record, PublicSymbol &symbol, bool withName) const {
+    std::vector<char> buffer;
+    uint16_t length;
+
+    if (static_cast<uint64_t>(record) + sizeof(length) > records.size()) {
+        return false;
+    }
+
+    memcpy(&length, records.read(record, sizeof(length), buffer), sizeof(length));
+    if (length < sizeof(uint16_t) || static_cast<uint64_t>(record) + sizeof(length) + length > records.size()) {
+        return false;
+    }
+
+    RecordReader reader(records.read(record + sizeof(length), length, buffer), length);
+    if (reader.u16() != S_PUB32) {
+        return false;
+    }
+
+    uint32_t flags = reader.u32();
+    uint32_t offset = reader.u32();
+    uint16_t segment = reader.u16();
+
+    int64_t address = dbi.getRelativeAddress(segment, offset);
+    if (address < 0) {
+        return false;
+    }
+
+    symbol.address = imageBase + static_cast<uint64_t>(address);
+    symbol.segment = segment;
+    symbol.isFunction = (flags & (PUBLIC_CODE | PUBLIC_FUNCTION)) != 0;
+    if (withName) {
+        symbol.name = reader.string();
+    }
+
+    return true;
+}
+
+bool PublicSymbolTable::findAddress(const std::string &name, uint64_t &address) const {
+    PublicSymbol symbol;
+
+    if (bucketStarts.empty()) {
+        for (const Entry &entry : entries) {
+            if (readSymbol(entry.record, symbol, true) && symbol.name == name) {
+                address = symbol.address;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    uint32_t bucket = hashStringV1(name) % IPHR_HASH;
+    for (uint32_t i = bucketStarts[bucket]; i < bucketStarts[bucket + 1]; i++) {
+        if (readSymbol(hashRecords[i], symbol, true) && symbol.name == name) {
+            address = symbol.address;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool PublicSymbolTable::findSymbol(uint64_t address, PublicSymbol &symbol) const {
+    auto it = std::upper_bound(entries.begin(), entries.end(), address, [](uint64_t value, const Entry &entry) {
+        return value < entry.address;
+    });
+
+    if (it == entries.begin()) {
+        return false;
+    }
+
+    return readSymbol((it - 1)->record, symbol, true);
+}
+
+void PublicSymbolTable::forEachSymbol(const std::function<void(const PublicSymbol &symbol)> &callback) const {
+    PublicSymbol symbol;
+
+    for (const Entry &entry : entries) {
+        if (readSymbol(entry.record, symbol, true)) {
+            callback(symbol);
+        }
+    }
+}
+
+}
+}
@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include "extractor/pdb/CodeView.hpp"
+#include "extractor/pdb/SymbolTable.hpp"
+
+namespace debugtocpp {
+namespace pdb {
+
+namespace {
+
+void forEachSymbol(const MsfStream &stream, uint32_t offset, uint32_t end,
+                   const std::function<void(uint16_t kind, RecordReader reader)> &callback) {
+    std::vector<char> buffer;
+    uint16_t length;
+
+    while (offset + sizeof(length) <= end) {
+        memcpy(&length, stream.read(offset, sizeof(length), buffer), sizeof(length));
+
+        if (length < sizeof(uint16_t) || offset + sizeof(length) + length > end) {
+            throw std::string("Invalid PDB symbol record at " + std::to_string(offset));
+        }
+
+        RecordReader reader(stream.read(offset + sizeof(length), length, buffer), length);
+        offset += sizeof(length) + length;
+
+        uint16_t kind = reader.u16();
+        callback(kind, reader);
+    }
+}
+
+std::vector<FunctionSymbol> readModule(const MsfStream &stream, uint32_t symbolBytes, const DbiStream &dbi, uint64_t imageBase) {
+    std::vector<FunctionSymbol> functions;
+    if (symbolBytes < sizeof(uint32_t)) {
+        return functions;
+    }
+
+    if (symbolBytes > stream.size()) {
+        throw std::string("Module symbols are larger than their stream");
+    }
+
+    std::vector<char> buffer;
+    uint32_t signature;
+    memcpy(&signature, stream.read(0, sizeof(signature), buffer), sizeof(signature));
+
+    if (signature != CV_SIGNATURE_C13) {
+        throw std::string("Unsupported module symbols signature " + std::to_string(signature));
+    }
+
+    // Arguments are collected only directly in a function, not in its blocks or inlined calls
+    int depth = 0;
+    bool inFunction = false;
+
+    forEachSymbol(stream, sizeof(signature), symbolBytes, [&](uint16_t kind, RecordReader reader) {
+        if (isScopeEndSymbol(kind)) {
+            depth = std::max(depth - 1, 0);
+            inFunction = inFunction && depth > 0;
+            return;
+        }
+
+        bool isProcedure = kind == S_GPROC32 || kind == S_LPROC32;
+        bool isProcedureId = kind == S_GPROC32_ID || kind == S_LPROC32_ID;
+
+        if (depth == 0 && (isProcedure || isProcedureId)) {
+            ProcedureSymbol procedure = readProcedureSymbol(reader);
+            int64_t address = dbi.getRelativeAddress(procedure.segment, procedure.offset);
+
+            if (address >= 0) {
+                FunctionSymbol function;
+                function.name = procedure.name;
+                function.address = imageBase + static_cast<uint64_t>(address);
+                function.length = procedure.length;
+                function.type = procedure.type;
+                function.isFunctionId = isProcedureId;
+
+                functions.push_back(function);
+                inFunction = true;
+            }
+        }
+
+        if (isScopeSymbol(kind)) {
+            depth++;
+            return;
+        }
+
+        if (!inFunction || depth != 1) {
+            return;
+        }
+
+        LocalSymbol local;
+        switch (kind) {
+            case S_REGREL32:
+                reader.i32(); // Offset
+                local.type = reader.u32();
+                reader.u16(); // Register
+                local.name = reader.string();
+                break;
+            case S_BPREL32:
+                reader.i32();
+                local.type = reader.u32();
+                local.name = reader.string();
+                break;
+            case S_LOCAL:
+                local.type = reader.u32();
+                if ((reader.u16() & LOCAL_IS_PARAMETER) == 0) {
+                    return;
+                }
+                local.name = reader.string();
+                break;
+            default:
+                return;
+        }
+
+        functions.back().arguments.push_back(local);
+    });
+
+    return functions;
+}
+
+}
+
+SymbolTable::SymbolTable(const MsfFile &msf, const DbiStream &dbi, uint64_t imageBase) {
+    loadModules(msf, dbi, imageBase);
+    loadGlobals(msf, dbi, imageBase);
+}
+
+// Modules are independent, so they are parsed in parallel and merged in their order
+void SymbolTable::loadModules(const MsfFile &msf, const DbiStream &dbi, uint64_t imageBase) {
+    const std::vector<ModuleInfo> &modules = dbi.getModules();
+
+    std::vector<std::vector<FunctionSymbol>> loaded(modules.size());
+    std::vector<std::string> errors(modules.size());
+    std::atomic<size_t> next(0);
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < modules.size(); i = next++) {
+            try {
+                loaded[i] = readModule(msf.getStream(modules[i].symbolStream), modules[i].symbolBytes, dbi, imageBase);
+            } catch (std::string &error) {
+                errors[i] = error;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    size_t threadCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), modules.size());
+    for (size_t i = 0; i < threadCount; i++) {
+        threads.emplace_back(worker);
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    size_t count = 0;
+    for (auto &module : loaded) {
+        count += module.size();
+    }
+    functions.reserve(count);
+
+    for (size_t i = 0; i < modules.size(); i++) {
+        if (!errors[i].empty()) {
+            std::cerr << "Warning: " << modules[i].name << ": " << errors[i] << std::endl;
+        }
+
+        std::move(loaded[i].begin(), loaded[i].end(), std::back_inserter(functions));
+    }
+
+    // Functions at the same address keep the module order
+    std::stable_sort(functions.begin(), functions.end(), [](const FunctionSymbol &a, const FunctionSymbol &b) {
+        return a.address < b.address;
+    });
+}
+
+void SymbolTable::loadGlobals(const MsfFile &msf, const DbiStream &dbi, uint64_t imageBase) {
+    MsfStream stream = msf.getStream(dbi.getSymbolRecordStream());
+
+    forEachSymbol(stream, 0, stream.size(), [&](uint16_t kind, RecordReader reader) {
+        if (kind != S_GDATA32 && kind != S_LDATA32) {
+            return;
+        }
+
+        DataSymbol data = readDataSymbol(reader);
+        int64_t address = dbi.getRelativeAddress(data.segment, data.offset);
+        if (address < 0) {
+            return;
+        }
+
+        VariableSymbol variable;
+        variable.name = data.name;
+        variable.address = imageBase + static_cast<uint64_t>(address);
+        variable.type = data.type;
+
+        globalVariables.push_back(variable);
+    });
+
+    std::stable_sort(globalVariables.begin(), globalVariables.end(), [](const VariableSymbol &a, const VariableSymbol &b) {
+        return a.address < b.address;
+    });
+}
+
+}
+}
@@ -0,0 +1,300 @@
+#include <algorithm>
+#include "extractor/pdb/TpiStream.hpp"
+
+namespace debugtocpp {
+namespace pdb {
+
+namespace {
+
+const uint32_t TPI_VERSION_V80 = 20040203;
+
+// Full definition with the name, of the same kind and unique name as the forward reference if there is one
+bool isDefinition(uint16_t kind, RecordReader reader, const std::string &name, const UdtRecord *reference) {
+    if (!isUdt(kind) || (reference != nullptr && kind != reference->kind)) {
+        return false;
+    }
+
+    UdtRecord udt = readUdt(kind, reader);
+    if (udt.isForwardReference() || udt.name != name) {
+        return false;
+    }
+
+    return reference == nullptr || reference->uniqueName.empty() || udt.uniqueName == reference->uniqueName;
+}
+
+}
+
+TpiStream::TpiStream(const MsfFile &msf, uint32_t streamIndex) : stream(msf.getStream(streamIndex)) {
+    if (stream.size() < sizeof(Header)) {
+        throw std::string("Missing PDB type stream");
+    }
+
+    std::vector<char> buffer;
+    memcpy(&header, stream.read(0, sizeof(Header), buffer), sizeof(Header));
+
+    if (header.version != TPI_VERSION_V80) {
+        throw std::string("Unsupported PDB type stream version " + std::to_string(header.version));
+    }
+
+    if (header.headerSize < sizeof(Header) || header.typeIndexBegin > header.typeIndexEnd ||
+        header.headerSize + static_cast<uint64_t>(header.typeRecordBytes) > stream.size()) {
+        throw std::string("Invalid PDB type stream header");
+    }
+
+    hashStream = msf.getStream(header.hashStreamIndex);
+    loadIndexOffsets();
+}
+
+// Few entries, one for every 8 KB of records
+void TpiStream::loadIndexOffsets() {
+    if (header.indexOffsetBufferOffset < 0 || header.indexOffsetBufferLength == 0 ||
+        static_cast<uint64_t>(header.indexOffsetBufferOffset) + header.indexOffsetBufferLength > hashStream.size()) {
+        return;
+    }
+
+    std::vector<char> buffer;
+    indexOffsets.resize(header.indexOffsetBufferLength / sizeof(IndexOffset));
+    auto length = static_cast<uint32_t>(indexOffsets.size() * sizeof(IndexOffset));
+    memcpy(indexOffsets.data(), hashStream.read(header.indexOffsetBufferOffset, length, buffer), length);
+
+    // Entries outside of the stream would make getRecord walk from a wrong place
+    auto invalid = std::find_if(indexOffsets.begin(), indexOffsets.end(), [&](const IndexOffset &entry) {
+        return entry.index < header.typeIndexBegin || entry.index >= header.typeIndexEnd || entry.offset >= header.typeRecordBytes;
+    });
+    auto byIndex = [](const IndexOffset &a, const IndexOffset &b) { return a.index < b.index; };
+
+    if (invalid != indexOffsets.end() || !std::is_sorted(indexOffsets.begin(), indexOffsets.end(), byIndex)) {
+        indexOffsets.clear();
+    }
+}
+
+void TpiStream::forEachRecord(const std::function<void(uint32_t, uint16_t, RecordReader)> &callback) const {
+    std::vector<char> buffer;
+    uint32_t offset = header.headerSize;
+    uint32_t end = header.headerSize + header.typeRecordBytes;
+
+    for (uint32_t index = header.typeIndexBegin; index < header.typeIndexEnd && offset < end; index++) {
+        uint16_t length;
+        memcpy(&length, stream.read(offset, sizeof(length), buffer), sizeof(length));
+
+        if (length < sizeof(uint16_t) || offset + sizeof(length) + length > end) {
+            throw std::string("Invalid PDB type record " + std::to_string(index));
+        }
+
+        // Records are parsed in place unless they cross a block boundary
+        RecordReader reader(stream.read(offset + sizeof(length), length, buffer), length);
+        offset += sizeof(length) + length;
+
+        uint16_t kind = reader.u16();
+        callback(index, kind, reader);
+    }
+}
+RecordReader TpiStream::getRecord(uint32_t index, uint16_t &kind, std::vector<char> &buffer) const {
+    if (index < header.typeIndexBegin || index >= header.typeIndexEnd) {
+        throw std::string("Type index " + std::to_string(index) + " is out of PDB type stream");
+    }
+
+    uint32_t current = header.typeIndexBegin;
+    uint32_t offset = header.headerSize;
+    uint32_t end = header.headerSize + header.typeRecordBytes;
+
+    auto nearest = std::upper_bound(indexOffsets.begin(), indexOffsets.end(), index, [](uint32_t value, const IndexOffset &entry) {
+        return value < entry.index;
+    });
+    if (nearest != indexOffsets.begin()) {
+        nearest--;
+        current = nearest->index;
+        offset = header.headerSize + nearest->offset;
+    }
+
+    uint16_t length;
+    for (;; current++) {
+        if (static_cast<uint64_t>(offset) + sizeof(length) > end) {
+            throw std::string("Invalid PDB type record " + std::to_string(current));
+        }
+
+        memcpy(&length, stream.read(offset, sizeof(length), buffer), sizeof(length));
+        if (length < sizeof(uint16_t) || offset + sizeof(length) + length > end) {
+            throw std::string("Invalid PDB type record " + std::to_string(current));
+        }
+
+        if (current == index) {
+            break;
+        }
+
+        offset += sizeof(length) + length;
+    }
+
+    RecordReader reader(stream.read(offset + sizeof(length), length, buffer), length);
+    kind = reader.u16();
+
+    return reader;
+}
+
+void TpiStream::forEachMember(uint32_t fieldList, const std::function<void(const MemberRecord &)> &callback) const {
+    std::vector<char> buffer;
+
+    while (fieldList != 0) {
+        uint16_t kind;
+        RecordReader reader = getRecord(fieldList, kind, buffer);
+        if (kind != LF_FIELDLIST) {
+            throw std::string("Type " + std::to_string(fieldList) + " is not a PDB field list");
+        }
+
+        // Long lists continue in another record
+        fieldList = 0;
+        while (reader.remaining() > 0) {
+            MemberRecord member = readMember(reader);
+            if (member.kind == LF_INDEX) {
+                fieldList = member.type;
+                continue;
+            }
+
+            callback(member);
+        }
+    }
+}
+
+// Hash values are read on the first lookup, listing types does not need them
+void TpiStream::loadHash() {
+    if (hashLoaded) {
+        return;
+    }
+
+    hashLoaded = true;
+
+    uint32_t typeCount = header.typeIndexEnd - header.typeIndexBegin;
+    bool validHashes = header.hashKeySize == sizeof(uint32_t) && header.hashBucketCount > 0 &&
+                       header.hashValueBufferOffset >= 0 &&
+                       header.hashValueBufferLength == static_cast<uint64_t>(typeCount) * sizeof(uint32_t) &&
+                       static_cast<uint64_t>(header.hashValueBufferOffset) + header.hashValueBufferLength <= hashStream.size();
+    if (!validHashes) {
+        return;
+    }
+
+    std::vector<char> buffer;
+    std::vector<uint32_t> hashes(typeCount);
+    if (typeCount > 0) {
+        memcpy(hashes.data(), hashStream.read(header.hashValueBufferOffset, header.hashValueBufferLength, buffer), header.hashValueBufferLength);
+    }
+
+    // Counting sort of type indices by bucket
+    bucketStarts.assign(header.hashBucketCount + 1, 0);
+    for (uint32_t hash : hashes) {
+        if (hash >= header.hashBucketCount) {
+            bucketStarts.clear();
+            return;
+        }
+
+        bucketStarts[hash + 1]++;
+    }
+
+    for (uint32_t i = 0; i < header.hashBucketCount; i++) {
+        bucketStarts[i + 1] += bucketStarts[i];
+    }
+
+    bucketIndices.resize(typeCount);
+    std::vector<uint32_t> next(bucketStarts.begin(), bucketStarts.end() - 1);
+    for (uint32_t i = 0; i < typeCount; i++) {
+        bucketIndices[next[hashes[i]]++] = header.typeIndexBegin + i;
+    }
+}
+
+uint32_t TpiStream::findInBucket(const std::string &key, const std::string &name, const UdtRecord *reference) {
+    std::vector<char> buffer;
+    uint32_t bucket = hashStringV1(key) % header.hashBucketCount;
+
+    for (uint32_t i = bucketStarts[bucket]; i < bucketStarts[bucket + 1]; i++) {
+        uint16_t kind;
+        RecordReader reader = getRecord(bucketIndices[i], kind, buffer);
+
+        if (isDefinition(kind, reader, name, reference)) {
+            return bucketIndices[i];
+        }
+    }
+
+    return 0;
+}
+
+uint32_t TpiStream::findLinear(const std::string &name, const UdtRecord *reference) const {
+    uint32_t found = 0;
+
+    forEachRecord([&](uint32_t index, uint16_t kind, RecordReader reader) {
+        if (found == 0 && isDefinition(kind, reader, name, reference)) {
+            found = index;
+        }
+    });
+
+    return found;
+}
+
+// One pass on the first miss, later misses are answered without walking the records again
+uint32_t TpiStream::findByName(const std::string &name) {
+    if (!namesIndexed) {
+        namesIndexed = true;
+
+        forEachRecord([&](uint32_t index, uint16_t kind, RecordReader reader) {
+            if (isUdt(kind)) {
+                UdtRecord udt = readUdt(kind, reader);
+                if (!udt.isForwardReference()) {
+                    definitionsByName.emplace(udt.name, index);
+                }
+            }
+        });
+    }
+
+    auto it = definitionsByName.find(name);
+    return it != definitionsByName.end() ? it->second : 0;
+}
+
+uint32_t TpiStream::findType(const std::string &name) {
+    loadHash();
+
+    uint32_t index = bucketStarts.empty() ? 0 : findInBucket(name, name, nullptr);
+
+    // Scoped and anonymous types are hashed by their unique names
+    return index != 0 ? index : findByName(name);
+}
+
+uint32_t TpiStream::resolveForwardReference(uint32_t index) {
+    if (index < header.typeIndexBegin) {
+        return index;
+    }
+
+    std::vector<char> buffer;
+    uint16_t kind;
+    RecordReader reader = getRecord(index, kind, buffer);
+
+    if (!isUdt(kind)) {
+        return index;
+    }
+
+    UdtRecord reference = readUdt(kind, reader);
+    if (!reference.isForwardReference()) {
+        return index;
+    }
+
+    loadHash();
+
+    uint32_t definition;
+    if (bucketStarts.empty()) {
+        // Types with the same name differ in kind or unique name, e.g. local classes of different functions
+        definition = findByName(reference.name);
+        if (definition != 0) {
+            RecordReader candidate = getRecord(definition, kind, buffer);
+            if (!isDefinition(kind, candidate, reference.name, &reference)) {
+                definition = findLinear(reference.name, &reference);
+            }
+        }
+    } else {
+        definition = findInBucket(reference.name, reference.name, &reference);
+        if (definition == 0 && !reference.uniqueName.empty()) {
+            definition = findInBucket(reference.uniqueName, reference.name, &reference);
+        }
+    }
+
+    return definition != 0 ? definition : index;
+}
+
+}
+}